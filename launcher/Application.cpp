@@ -98,6 +98,7 @@
 #include <QTranslator>
 #include <QWindow>
 
+#include "ContentStore.h"
 #include "InstanceList.h"
 #include "MTPixmapCache.h"
 
@@ -237,7 +238,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
           { { "a", "profile" }, "Use the account specified by its profile name (only valid in combination with --launch)", "profile" },
           { "alive", "Write a small '" + liveCheckFile + "' file after the launcher starts" },
           { { "I", "import" }, "Import instance or resource from specified local path or URL", "url" },
-          { "show", "Opens the window for the specified instance (by instance ID)", "show" } });
+          { "show", "Opens the window for the specified instance (by instance ID)", "show" },
+          { "gc-store", "Remove the files no instance uses anymore from the shared content store, then quit" } });
     // Has to be positional for some OS to handle that properly
     parser.addPositionalArgument("URL", "Import the resource(s) at the given URL(s) (same as -I / --import)", "[URL...]");
 
@@ -352,6 +354,12 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_peerInstance = new LocalPeer(this, appID);
         connect(m_peerInstance, &LocalPeer::messageReceived, this, &Application::messageReceived);
         if (m_peerInstance->isClient()) {
+            if (parser.isSet("gc-store")) {
+                std::cerr << "The content store can't be cleaned up while the launcher is running, close it first" << std::endl;
+                m_status = Application::Failed;
+                return;
+            }
+
             int timeout = 2000;
 
             if (m_instanceIdToLaunch.isEmpty()) {
@@ -385,6 +393,15 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         }
     }
 
+    // Only done when no other copy of the launcher uses this data folder, as it removes the partial files in the store and
+    // rewrites the reference lists, which that copy could be in the middle of adding to
+    if (parser.isSet("gc-store")) {
+        auto stats = ContentStore(QDir("store").absolutePath()).collectGarbage();
+        std::cout << "Removed " << stats.objects << " unused files (" << stats.bytes << " bytes) from the content store" << std::endl;
+        m_status = Application::Succeeded;
+        return;
+    }
+
     // init the logger
     {
         static const QString baseLogFile = BuildConfig.LAUNCHER_NAME + "-%0.log";
@@ -553,6 +570,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
         m_settings->registerSetting("NumberOfConcurrentTasks", 10);
         m_settings->registerSetting("NumberOfConcurrentDownloads", 6);
+        m_settings->registerSetting("UseHttp2", false);
 
         QString defaultMonospace;
         int defaultSize = 11;
@@ -868,6 +886,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         qDebug() << "<> Cache initialized.";
     }
 
+    m_contentStore = std::make_shared<ContentStore>(QDir("store").absolutePath());
+
     // now we have network, download translation updates
     m_translations->downloadIndex();
 
@@ -58,6 +58,7 @@ class SetupWizard;
 class GenericPageProvider;
 class QFile;
 class HttpMetaCache;
+class ContentStore;
 class SettingsObject;
 class InstanceList;
 class AccountList;
@@ -138,6 +139,8 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    std::shared_ptr<ContentStore> contentStore() { return m_contentStore; }
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     void updateCapabilities();
@@ -236,6 +239,7 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
+    std::shared_ptr<ContentStore> m_contentStore;
 
     std::shared_ptr<SettingsObject> m_settings;
     std::shared_ptr<InstanceList> m_instances;
@@ -107,6 +107,15 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
     m_settings->registerSetting("Profiler", "");
 }
 
+void BaseInstance::guessLevels(const QStringList& lines, QList<MessageLevel::Enum>& levels)
+{
+    for (int i = 0; i < lines.size(); i++) {
+        if (MessageLevel::isUndetermined(levels[i])) {
+            levels[i] = guessLevel(lines[i], levels[i]);
+        }
+    }
+}
+
 QString BaseInstance::getPreLaunchCommand()
 {
     return settings()->get("PreLaunchCommand").toString();
@@ -150,6 +150,9 @@ class BaseInstance : public QObject, public std::enable_shared_from_this<BaseIns
     /// guess log level from a line of game log
     virtual MessageLevel::Enum guessLevel([[maybe_unused]] const QString& line, MessageLevel::Enum level) { return level; }
 
+    /// guess log levels of a batch of game log lines in place, only undetermined levels are touched
+    virtual void guessLevels(const QStringList& lines, QList<MessageLevel::Enum>& levels);
+
     virtual QStringList extraArguments();
 
     /// Traits. Normally inside the version, depends on instance implementation.
@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ContentStore.h"
+
+#include <QDebug>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QtConcurrentRun>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/HashUtils.h"
+
+/* Layout of the store:
+ *   objects/<first two of sha1>/<sha1>        the file itself
+ *   objects/<first two of sha1>/<sha1>.refs   absolute paths it was put at, one per line
+ *   sha512/<first two of sha512>/<sha512>     the sha1 of the object with that sha512
+ */
+
+namespace {
+QStringList readLines(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+
+    QStringList lines;
+    for (auto& line : QString::fromUtf8(file.readAll()).split('\n')) {
+        if (!line.trimmed().isEmpty())
+            lines.append(line.trimmed());
+    }
+    return lines;
+}
+
+void writeLines(const QString& path, const QStringList& lines)
+{
+    try {
+        FS::write(path, (lines.join('\n') + '\n').toUtf8());
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to update" << path << ":" << e.cause();
+    }
+}
+
+bool isSha1(const QString& hash)
+{
+    static const QRegularExpression sha1(QRegularExpression::anchoredPattern("[0-9a-f]{40}"));
+    return sha1.match(hash).hasMatch();
+}
+}  // namespace
+
+ContentStore::ContentStore(QString root) : m_root(std::move(root)) {}
+
+bool ContentStore::supports(const QString& algorithm)
+{
+    return algorithm == "sha1" || algorithm == "sha512";
+}
+
+QString ContentStore::objectPath(const QString& sha1) const
+{
+    return FS::PathCombine(m_root, "objects", sha1.left(2), sha1);
+}
+
+QString ContentStore::refsPath(const QString& sha1) const
+{
+    return objectPath(sha1) + ".refs";
+}
+
+QString ContentStore::aliasPath(const QString& sha512) const
+{
+    return FS::PathCombine(m_root, "sha512", sha512.left(2), sha512);
+}
+
+QString ContentStore::resolve(const QString& algorithm, const QString& hash) const
+{
+    auto lower = hash.toLower();
+    QString sha1;
+    if (algorithm == "sha1") {
+        sha1 = lower;
+    } else if (algorithm == "sha512" && !lower.isEmpty()) {
+        auto lines = readLines(aliasPath(lower));
+        if (!lines.isEmpty())
+            sha1 = lines.first();
+    }
+    return isSha1(sha1) ? sha1 : QString();
+}
+
+QString ContentStore::find(const QString& algorithm, const QString& hash) const
+{
+    auto sha1 = resolve(algorithm, hash);
+    if (sha1.isEmpty())
+        return {};
+
+    auto path = objectPath(sha1);
+    return QFileInfo::exists(path) ? path : QString();
+}
+
+bool ContentStore::add(const QString& file, const QString& algorithm, const QString& hash)
+{
+    if (!supports(algorithm) || hash.isEmpty())
+        return false;
+
+    auto digests = Hashing::hashFile(file, Hashing::Algorithm::Sha1 | Hashing::Algorithm::Sha512);
+    if (!digests.isValid()) {
+        qWarning() << "Not storing" << file << ":" << digests.error;
+        return false;
+    }
+    if (digests.get(*Hashing::algorithmFromName(algorithm)).compare(hash, Qt::CaseInsensitive) != 0) {
+        qWarning() << "Not storing" << file << ": its" << algorithm << "isn't the expected one";
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    auto object = objectPath(digests.sha1);
+    if (!QFileInfo::exists(object)) {
+        auto objectDir = QFileInfo(object).path();
+        if (!FS::ensureFolderPathExists(objectDir))
+            return false;
+
+        // A hard link would let the instance change the object through the file, and a plain copy
+        // would only take more space than it could ever save
+        FS::FilePlacer placer(QFileInfo(file).path(), objectDir, false);
+        if (placer.method() != FS::FilePlacer::Clone)
+            return false;
+
+        auto part = object + ".part";
+        QFile::remove(part);
+        if (!placer.place(file, part) || !QFile::rename(part, object)) {
+            QFile::remove(part);
+            qWarning() << "Failed to store" << file;
+            return false;
+        }
+    }
+
+    auto alias = aliasPath(digests.sha512);
+    if (!QFileInfo::exists(alias))
+        writeLines(alias, { digests.sha1 });
+
+    addReference(digests.sha1, file);
+    return true;
+}
+
+bool ContentStore::materialize(const QString& algorithm, const QString& hash, const QString& target)
+{
+    auto sha1 = resolve(algorithm, hash);
+    if (sha1.isEmpty())
+        return false;
+
+    // Keeps the garbage collection from removing the object under us
+    QMutexLocker locker(&m_mutex);
+
+    auto object = objectPath(sha1);
+    auto targetDir = QFileInfo(target).path();
+    if (!QFileInfo::exists(object) || !FS::ensureFolderPathExists(targetDir))
+        return false;
+
+    // Don't hand out an object that got changed since it was stored
+    auto digests = Hashing::hashFile(object, Hashing::Algorithm::Sha1);
+    if (!digests.isValid() || digests.sha1 != sha1) {
+        qWarning() << "Dropping" << object << "from the content store, it's not the file it was stored as";
+        QFile::remove(object);
+        QFile::remove(refsPath(sha1));
+        return false;
+    }
+
+    FS::FilePlacer placer(QFileInfo(object).path(), targetDir, false);
+    if (!placer.place(object, target)) {
+        qWarning() << "Failed to put" << object << "at" << target;
+        return false;
+    }
+
+    addReference(sha1, target);
+    return true;
+}
+
+void ContentStore::addReference(const QString& sha1, const QString& file)
+{
+    auto path = refsPath(sha1);
+    auto refs = readLines(path);
+    auto absolute = QFileInfo(file).absoluteFilePath();
+    if (refs.contains(absolute))
+        return;
+
+    refs.append(absolute);
+    writeLines(path, refs);
+}
+
+ContentStore::GarbageStats ContentStore::collectGarbage()
+{
+    QMutexLocker locker(&m_mutex);
+
+    GarbageStats stats;
+
+    QStringList objects;
+    QStringList leftovers;
+    QDirIterator iter(FS::PathCombine(m_root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+    while (iter.hasNext()) {
+        iter.next();
+        auto name = iter.fileName();
+        if (isSha1(name))
+            objects.append(name);
+        else if (name.endsWith(".part"))
+            leftovers.append(iter.filePath());
+    }
+
+    for (auto& sha1 : objects) {
+        auto refs = readLines(refsPath(sha1));
+        QStringList alive;
+        for (auto& ref : refs) {
+            if (QFileInfo::exists(ref))
+                alive.append(ref);
+        }
+
+        if (!alive.isEmpty()) {
+            if (alive.size() != refs.size())
+                writeLines(refsPath(sha1), alive);
+            continue;
+        }
+
+        auto path = objectPath(sha1);
+        auto size = QFileInfo(path).size();
+        if (QFile::remove(path)) {
+            QFile::remove(refsPath(sha1));
+            stats.objects++;
+            stats.bytes += size;
+        }
+    }
+
+    for (auto& leftover : leftovers)
+        QFile::remove(leftover);
+
+    QStringList aliases;
+    QDirIterator aliasIter(FS::PathCombine(m_root, "sha512"), QDir::Files, QDirIterator::Subdirectories);
+    while (aliasIter.hasNext())
+        aliases.append(aliasIter.next());
+
+    for (auto& alias : aliases) {
+        auto lines = readLines(alias);
+        if (lines.isEmpty() || !QFileInfo::exists(objectPath(lines.first())))
+            QFile::remove(alias);
+    }
+
+    qDebug() << "Removed" << stats.objects << "unused objects," << stats.bytes << "bytes, from the content store at" << m_root;
+    return stats;
+}
+
+ContentStoreMaterializeTask::ContentStoreMaterializeTask(std::shared_ptr<ContentStore> store,
+                                                         QString algorithm,
+                                                         QString hash,
+                                                         QString target)
+    : m_store(std::move(store)), m_algorithm(std::move(algorithm)), m_hash(std::move(hash)), m_target(std::move(target))
+{}
+
+void ContentStoreMaterializeTask::executeTask()
+{
+    setStatus(tr("Reusing the copy of %1 from other instances").arg(QFileInfo(m_target).fileName()));
+
+    // Checking the object reads all of it, and the placement may end up copying it
+    m_future = QtConcurrent::run(Hashing::pool(), [store = m_store, algorithm = m_algorithm, hash = m_hash, target = m_target] {
+        return store->materialize(algorithm, hash, target);
+    });
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &ContentStoreMaterializeTask::materializeFinished);
+    m_watcher.setFuture(m_future);
+}
+
+void ContentStoreMaterializeTask::materializeFinished()
+{
+    if (m_future.result())
+        emitSucceeded();
+    else
+        emitFailed(tr("The shared copy of %1 couldn't be used").arg(QFileInfo(m_target).fileName()));
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QString>
+
+#include "tasks/Task.h"
+
+/* A folder of files keyed by their SHA1, so instances can share the same mod jars instead of each keeping its own copy.
+ * Files are only stored when the file system can reflink them, and are put into instances as reflinks, or copies
+ * where that's not possible. Hard links are never used, as changing the file in one instance would change it in all.
+ * Objects can also be looked up by SHA512, through small alias files pointing to the SHA1.
+ *
+ * Every object remembers the places it was put at, so the ones nobody uses anymore can be removed.
+ * Removing an object never breaks an instance: reflinks keep the data alive on their own.
+ */
+class ContentStore {
+   public:
+    struct GarbageStats {
+        int objects = 0;
+        qint64 bytes = 0;
+    };
+
+    explicit ContentStore(QString root);
+
+    /** Whether objects can be looked up by this kind of hash ("sha1" and "sha512") */
+    static bool supports(const QString& algorithm);
+
+    /** Path of the stored object with the given hash, empty if there's none */
+    QString find(const QString& algorithm, const QString& hash) const;
+
+    /** Stores the file, if its hash is the expected one, and references the object from where the file is.
+     *  Reads the whole file, so don't call it on the GUI thread. */
+    bool add(const QString& file, const QString& algorithm, const QString& hash);
+
+    /** Puts the object with the given hash at target, which must not exist yet, and references it from there.
+     *  The object is checked against its hash first, and dropped if it doesn't match. Don't call it on the GUI thread. */
+    bool materialize(const QString& algorithm, const QString& hash, const QString& target);
+
+    /** Forgets the references whose files are gone, and removes the objects and aliases left without any */
+    GarbageStats collectGarbage();
+
+    const QString& root() const { return m_root; }
+
+   private:
+    QString objectPath(const QString& sha1) const;
+    QString refsPath(const QString& sha1) const;
+    QString aliasPath(const QString& sha512) const;
+
+    QString resolve(const QString& algorithm, const QString& hash) const;
+    void addReference(const QString& sha1, const QString& file);
+
+    QString m_root;
+
+    // Guards the reference lists, which are read, changed and written back
+    QMutex m_mutex;
+};
+
+/* Materializes a stored object as a step of a bigger task, failing if it's not there anymore */
+class ContentStoreMaterializeTask : public Task {
+    Q_OBJECT
+   public:
+    ContentStoreMaterializeTask(std::shared_ptr<ContentStore> store, QString algorithm, QString hash, QString target);
+
+   protected slots:
+    void executeTask() override;
+    void materializeFinished();
+
+   private:
+    std::shared_ptr<ContentStore> m_store;
+    QString m_algorithm;
+    QString m_hash;
+    QString m_target;
+
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
+};
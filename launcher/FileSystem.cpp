@@ -1273,9 +1273,6 @@ bool clone::operator()(const QString& offset, bool dryRun)
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
 {
-    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
-    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
-
     FilesystemInfo srcinfo = statFS(src);
     FilesystemInfo dstinfo = statFS(dst);
 
@@ -1285,6 +1282,14 @@ bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
         return false;
     }
 
+    return clone_file_unchecked(src, dst, ec);
+}
+
+bool clone_file_unchecked(const QString& src, const QString& dst, std::error_code& ec)
+{
+    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
+    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
+
 #if defined(Q_OS_WIN)
 
     if (!win_ioctl_clone(src_path, dst_path, ec)) {
@@ -1574,6 +1579,48 @@ bool canLink(const QString& src, const QString& dst)
     return canLinkOnFS(src) && canLinkOnFS(dst);
 }
 
+bool hard_link_file(const QString& src, const QString& dst, std::error_code& ec)
+{
+    fs::create_hard_link(StringUtils::toStdString(src), StringUtils::toStdString(dst), ec);
+    return !ec;
+}
+
+FilePlacer::FilePlacer(const QString& srcDir, const QString& dstDir, bool allowHardLink)
+{
+    m_canHardLink = allowHardLink && canLink(srcDir, dstDir) && statFS(srcDir).rootPath == statFS(dstDir).rootPath;
+    m_method = canClone(srcDir, dstDir) ? Clone : (m_canHardLink ? HardLink : Copy);
+}
+
+bool FilePlacer::place(const QString& src, const QString& dst)
+{
+    // A missing file says nothing about whether cloning or linking works
+    if (!QFileInfo::exists(src))
+        return false;
+
+    std::error_code ec;
+    if (m_method == Clone) {
+        if (clone_file_unchecked(src, dst, ec)) {
+            cloned++;
+            return true;
+        }
+        QFile::remove(dst);
+        m_method = m_canHardLink ? HardLink : Copy;
+    }
+    if (m_method == HardLink) {
+        ec.clear();
+        if (hard_link_file(src, dst, ec)) {
+            linked++;
+            return true;
+        }
+        m_method = Copy;
+    }
+    if (QFile::copy(src, dst)) {
+        copied++;
+        return true;
+    }
+    return false;
+}
+
 uintmax_t hardLinkCount(const QString& path)
 {
     std::error_code err;
@@ -40,6 +40,7 @@
 #include "Exception.h"
 #include "pathmatcher/IPathMatcher.h"
 
+#include <atomic>
 #include <system_error>
 
 #include <QDir>
@@ -523,6 +524,12 @@ class clone : public QObject {
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec);
 
+/**
+ * @brief clone/reflink file from src to dst, for callers that already checked canClone for both places
+ *
+ */
+bool clone_file_unchecked(const QString& src, const QString& dst, std::error_code& ec);
+
 #if defined(Q_OS_WIN)
 bool win_ioctl_clone(const std::wstring& src_path, const std::wstring& dst_path, std::error_code& ec);
 #elif defined(Q_OS_LINUX)
@@ -549,6 +556,44 @@ bool canLinkOnFS(FilesystemType type);
  */
 bool canLink(const QString& src, const QString& dst);
 
+/**
+ * @brief hard link file from src to dst
+ *
+ */
+bool hard_link_file(const QString& src, const QString& dst, std::error_code& ec);
+
 uintmax_t hardLinkCount(const QString& path);
 
+/**
+ * @brief puts files from one folder into another the cheapest way that works between them:
+ * reflink, then hard link, then copy. Once a way fails it isn't tried again.
+ * Can be used from several threads at once.
+ */
+class FilePlacer {
+   public:
+    enum Method { Clone, HardLink, Copy };
+
+    /**
+     * @param allowHardLink false when the files placed in dstDir may be written to, which would change the source file through
+     * a hard link. Reflinks and copies are independent of the source.
+     */
+    FilePlacer(const QString& srcDir, const QString& dstDir, bool allowHardLink = true);
+
+    /**
+     * @brief place a copy of src at dst, which must not exist yet
+     * @return false if src doesn't exist or couldn't even be copied
+     */
+    bool place(const QString& src, const QString& dst);
+
+    Method method() const { return m_method; }
+
+    std::atomic<int> cloned{ 0 };
+    std::atomic<int> linked{ 0 };
+    std::atomic<int> copied{ 0 };
+
+   private:
+    bool m_canHardLink;
+    std::atomic<Method> m_method;
+};
+
 }  // namespace FS
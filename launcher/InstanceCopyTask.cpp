@@ -37,6 +37,7 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyP
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
+    m_origInstance->settings()->flush();
 
     auto copySaves = [&]() {
         QFileInfo mcDir(FS::PathCombine(m_stagingPath, "minecraft"));
@@ -162,6 +163,8 @@ void InstanceCopyTask::copyFinished()
         FS::write(allowed_symlinks_file.filePath(), allowed_symlinks);
     }
 
+    // the staging folder is moved into place as soon as this succeeds
+    instanceSettings->flush();
     emitSucceeded();
 }
 
@@ -54,11 +54,8 @@
 
 #include "net/ApiDownload.h"
 
-#include <QtConcurrentRun>
 #include <algorithm>
 
-#include <quazip/quazipdir.h>
-
 InstanceImportTask::InstanceImportTask(const QUrl& sourceUrl, QWidget* parent, QMap<QString, QString>&& extra_info)
     : m_sourceUrl(sourceUrl), m_extra_info(extra_info), m_parent(parent)
 {}
@@ -70,11 +67,9 @@ bool InstanceImportTask::abort()
 
     if (m_filesNetJob)
         m_filesNetJob->abort();
-    if (m_extractFuture.isRunning()) {
-        // NOTE: The tasks created by QtConcurrent::run() can't actually get cancelled,
-        // but we can use this call to check the state when the extraction finishes.
-        m_extractFuture.cancel();
-        m_extractFuture.waitForFinished();
+    if (m_extractTask && m_extractTask->isRunning()) {
+        // aborted once the extraction actually stops, so nothing is written into the staging folder after it's gone
+        return m_extractTask->abort();
     }
 
     return Task::abort();
@@ -141,18 +136,23 @@ void InstanceImportTask::processZipPack()
     QDir extractDir(m_stagingPath);
     qDebug() << "Attempting to create instance from" << m_archivePath;
 
-    // open the zip and find relevant files in it
-    m_packZip.reset(new QuaZip(m_archivePath));
-    if (!m_packZip->open(QuaZip::mdUnzip)) {
-        emitFailed(tr("Unable to open supplied modpack zip file."));
-        return;
+    // read the central directory once, everything below only looks at that
+    QList<QuaZipFileInfo64> entries;
+    {
+        QuaZip packZip(m_archivePath);
+        if (!packZip.open(QuaZip::mdUnzip)) {
+            emitFailed(tr("Unable to open supplied modpack zip file."));
+            return;
+        }
+        entries = packZip.getFileInfoList64();
     }
-
-    QuaZipDir packZipDir(m_packZip.get());
+    QStringList names;
+    for (auto& entry : entries)
+        names.append(entry.name);
 
     // https://docs.modrinth.com/docs/modpacks/format_definition/#storage
-    bool modrinthFound = packZipDir.exists("/modrinth.index.json");
-    bool technicFound = packZipDir.exists("/bin/modpack.jar") || packZipDir.exists("/bin/version.json");
+    bool modrinthFound = names.contains("modrinth.index.json");
+    bool technicFound = names.contains("bin/modpack.jar") || names.contains("bin/version.json");
     QString root;
 
     // NOTE: Prioritize modpack platforms that aren't searched for recursively.
@@ -170,13 +170,12 @@ void InstanceImportTask::processZipPack()
     } else {
         QStringList paths_to_ignore{ "overrides/" };
 
-        if (QString mmcRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "instance.cfg", paths_to_ignore); !mmcRoot.isNull()) {
+        if (QString mmcRoot = MMCZip::findFolderOfFileInZip(names, "instance.cfg", paths_to_ignore); !mmcRoot.isNull()) {
             // process as MultiMC instance/pack
             qDebug() << "MultiMC:" << mmcRoot;
             root = mmcRoot;
             m_modpackType = ModpackType::MultiMC;
-        } else if (QString flameRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "manifest.json", paths_to_ignore);
-                   !flameRoot.isNull()) {
+        } else if (QString flameRoot = MMCZip::findFolderOfFileInZip(names, "manifest.json", paths_to_ignore); !flameRoot.isNull()) {
             // process as Flame pack
             qDebug() << "Flame:" << flameRoot;
             root = flameRoot;
@@ -189,22 +188,25 @@ void InstanceImportTask::processZipPack()
     }
 
     // make sure we extract just the pack
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
-    m_extractFutureWatcher.setFuture(m_extractFuture);
+    auto extractTask = makeShared<MMCZip::ExtractZipTask>(m_archivePath, extractDir, root);
+    extractTask->setEntries(entries);
+    connect(extractTask.get(), &Task::succeeded, this, &InstanceImportTask::extractFinished);
+    connect(extractTask.get(), &Task::progress, this, &InstanceImportTask::setProgress);
+    connect(extractTask.get(), &Task::failed, this, [this](QString reason) {
+        m_extractTask.reset();
+        emitFailed(tr("Failed to extract modpack:\n%1").arg(reason));
+    });
+    connect(extractTask.get(), &Task::aborted, this, [this] {
+        m_extractTask.reset();
+        emitAborted();
+    });
+    m_extractTask = extractTask;
+    m_extractTask->start();
 }
 
 void InstanceImportTask::extractFinished()
 {
-    m_packZip.reset();
-
-    if (m_extractFuture.isCanceled())
-        return;
-    if (!m_extractFuture.result().has_value()) {
-        emitFailed(tr("Failed to extract modpack"));
-        return;
-    }
+    m_extractTask.reset();
 
     QDir extractDir(m_stagingPath);
 
@@ -333,6 +335,9 @@ void InstanceImportTask::processMultiMC()
             iconList->installIcons({ importIconPath });
         }
     }
+
+    // the staging folder is moved into place as soon as this succeeds
+    instanceSettings->flush();
     emitSucceeded();
 }
 
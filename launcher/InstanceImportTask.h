@@ -35,8 +35,6 @@
 
 #pragma once
 
-#include <QFuture>
-#include <QFutureWatcher>
 #include <QUrl>
 #include "InstanceTask.h"
 #include "QObjectPtr.h"
@@ -46,7 +44,6 @@
 
 #include <optional>
 
-class QuaZip;
 namespace Flame {
 class FileResolvingTask;
 }
@@ -83,9 +80,7 @@ class InstanceImportTask : public InstanceTask {
     QUrl m_sourceUrl;
     QString m_archivePath;
     bool m_downloadRequired = false;
-    std::unique_ptr<QuaZip> m_packZip;
-    QFuture<std::optional<QStringList>> m_extractFuture;
-    QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
+    Task::Ptr m_extractTask;
     QVector<Flame::File> m_blockedMods;
     enum class ModpackType {
         Unknown,
@@ -51,6 +51,7 @@
 #include <QTimer>
 #include <QUuid>
 #include <QXmlStreamReader>
+#include <QtConcurrentMap>
 
 #include "BaseInstance.h"
 #include "ExponentialSeries.h"
@@ -426,27 +427,54 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr>&
     return out;
 }
 
+namespace {
+// What discovery found in one folder of the instances folder
+struct DiscoveredFolder {
+    bool isInstance = false;
+    bool hasConfig = false;
+    INIFile config;
+};
+}  // namespace
+
 QList<InstanceId> InstanceList::discoverInstances()
 {
     qDebug() << "Discovering instances in" << m_instDir;
-    QList<InstanceId> out;
+    QStringList subDirs;
     QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
-    while (iter.hasNext()) {
-        QString subDir = iter.next();
+    while (iter.hasNext())
+        subDirs.append(iter.next());
+
+    // Looking for instance.cfg and reading it is all waiting on the disk, which adds up with hundreds of instances
+    // on a network drive, so every folder is looked at at once. Instances that are already loaded only get checked.
+    auto loaded = getIdMapping(m_instances);
+    auto instDirPath = QFileInfo(m_instDir).canonicalFilePath();
+    auto discovered = QtConcurrent::blockingMapped<QList<DiscoveredFolder>>(subDirs, [&loaded, instDirPath](const QString& subDir) {
+        DiscoveredFolder folder;
         QFileInfo dirInfo(subDir);
-        if (!QFileInfo(FS::PathCombine(subDir, "instance.cfg")).exists())
-            continue;
+        auto configPath = FS::PathCombine(subDir, "instance.cfg");
+        if (!QFileInfo::exists(configPath))
+            return folder;
         // if it is a symlink, ignore it if it goes to the instance folder
-        if (dirInfo.isSymLink()) {
-            QFileInfo targetInfo(dirInfo.symLinkTarget());
-            QFileInfo instDirInfo(m_instDir);
-            if (targetInfo.canonicalPath() == instDirInfo.canonicalFilePath()) {
-                qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
-                continue;
-            }
+        if (dirInfo.isSymLink() && QFileInfo(dirInfo.symLinkTarget()).canonicalPath() == instDirPath) {
+            qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
+            return folder;
         }
-        auto id = dirInfo.fileName();
+        folder.isInstance = true;
+        if (!loaded.contains(dirInfo.fileName()))
+            folder.hasConfig = folder.config.loadFile(configPath);
+        return folder;
+    });
+
+    QList<InstanceId> out;
+    m_discoveredConfigs.clear();
+    for (int i = 0; i < subDirs.size(); i++) {
+        auto& folder = discovered[i];
+        if (!folder.isInstance)
+            continue;
+        auto id = QFileInfo(subDirs[i]).fileName();
         out.append(id);
+        if (folder.hasConfig)
+            m_discoveredConfigs.insert(id, std::move(folder.config));
         qDebug() << "Found instance ID" << id;
     }
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
@@ -628,7 +656,14 @@ InstancePtr InstanceList::loadInstance(const InstanceId& id)
     }
 
     auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+    auto configPath = FS::PathCombine(instanceRoot, "instance.cfg");
+    std::shared_ptr<INISettingsObject> instanceSettings;
+    if (auto config = m_discoveredConfigs.find(id); config != m_discoveredConfigs.end()) {
+        instanceSettings = std::make_shared<INISettingsObject>(configPath, std::move(*config));
+        m_discoveredConfigs.erase(config);
+    } else {
+        instanceSettings = std::make_shared<INISettingsObject>(configPath);
+    }
     InstancePtr inst;
 
     instanceSettings->registerSetting("InstanceType", "");
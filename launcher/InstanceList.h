@@ -43,6 +43,7 @@
 #include <QStack>
 
 #include "BaseInstance.h"
+#include "settings/INIFile.h"
 
 class QFileSystemWatcher;
 class InstanceTask;
@@ -197,6 +198,8 @@ class InstanceList : public QAbstractListModel {
     QSet<QString> m_collapsedGroups;
     QMap<InstanceId, GroupId> m_instanceGroupIndex;
     QSet<InstanceId> instanceSet;
+    // instance.cfg of the instances discovered but not loaded yet, read along with the discovery
+    QHash<InstanceId, INIFile> m_discoveredConfigs;
     bool m_groupsLoaded = false;
     bool m_instancesProbed = false;
 
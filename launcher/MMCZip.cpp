@@ -44,52 +44,109 @@
 #include <QDebug>
 #include <QUrl>
 
+#include <algorithm>
+
 #if defined(LAUNCHER_APPLICATION)
 #include <QtConcurrentRun>
+#include <zlib.h>
+
+#include <atomic>
+#include <deque>
 #endif
 
 namespace MMCZip {
+namespace {
+// Copies the current entry of 'from' the way it's compressed, without inflating and deflating it again
+bool copyEntryRaw(QuaZip& from, QuaZip* into, const QuaZipFileInfo64& info)
+{
+    QuaZipFile fileInsideMod(&from);
+    int method = 0;
+    int level = 0;
+    if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true)) {
+        qCritical() << "Failed to open " << info.name << " from " << from.getZipName();
+        return false;
+    }
+
+    QuaZipNewInfo info_out(info.name);
+    info_out.dateTime = info.dateTime;
+    info_out.externalAttr = info.externalAttr;
+    // a raw entry can't be measured while it's written, so its size and checksum are passed along
+    info_out.uncompressedSize = info.uncompressedSize;
+
+    QuaZipFile zipOutFile(into);
+    if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info.crc, method, level, true)) {
+        qCritical() << "Failed to open " << info.name << " in the jar";
+        fileInsideMod.close();
+        return false;
+    }
+    bool copied = JlCompress::copyData(fileInsideMod, zipOutFile);
+    zipOutFile.close();
+    fileInsideMod.close();
+    if (!copied || zipOutFile.getZipError() != 0) {
+        qCritical() << "Failed to copy data of " << info.name << " into the jar";
+        return false;
+    }
+    return true;
+}
+
+// Inflates the current entry of 'from' and deflates it into 'into', for what can't be copied as it is
+bool copyEntry(QuaZip& from, QuaZip* into)
+{
+    QuaZipFile fileInsideMod(&from);
+    if (!fileInsideMod.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to open " << from.getCurrentFileName() << " from " << from.getZipName();
+        return false;
+    }
+
+    QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+
+    QuaZipFile zipOutFile(into);
+    if (!zipOutFile.open(QIODevice::WriteOnly, info_out)) {
+        qCritical() << "Failed to open " << info_out.name << " in the jar";
+        fileInsideMod.close();
+        return false;
+    }
+    if (!JlCompress::copyData(fileInsideMod, zipOutFile)) {
+        zipOutFile.close();
+        fileInsideMod.close();
+        qCritical() << "Failed to copy data of " << info_out.name << " into the jar";
+        return false;
+    }
+    zipOutFile.close();
+    fileInsideMod.close();
+    return true;
+}
+}  // namespace
+
 // ours
 bool mergeZipFiles(QuaZip* into, QFileInfo from, QSet<QString>& contained, const FilterFunction& filter)
 {
     QuaZip modZip(from.filePath());
     modZip.open(QuaZip::mdUnzip);
 
-    QuaZipFile fileInsideMod(&modZip);
-    QuaZipFile zipOutFile(into);
+    int skipped = 0;
+    QuaZipFileInfo64 info;
     for (bool more = modZip.goToFirstFile(); more; more = modZip.goToNextFile()) {
         QString filename = modZip.getCurrentFileName();
-        if (filter && !filter(filename)) {
-            qDebug() << "Skipping file " << filename << " from " << from.fileName() << " - filtered";
-            continue;
-        }
-        if (contained.contains(filename)) {
-            qDebug() << "Skipping already contained file " << filename << " from " << from.fileName();
+        if ((filter && !filter(filename)) || contained.contains(filename)) {
+            skipped++;
             continue;
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open " << filename << " from " << from.fileName();
+        if (!modZip.getCurrentFileInfo(&info)) {
+            qCritical() << "Failed to read " << filename << " from " << from.fileName();
             return false;
         }
 
-        QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
-
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out)) {
-            qCritical() << "Failed to open " << filename << " in the jar";
-            fileInsideMod.close();
+        // Stored and deflated entries are copied as they are. The zip writer can't take anything else raw,
+        // and encrypted entries would lose their encryption header.
+        bool raw = (info.method == 0 || info.method == Z_DEFLATED) && !(info.flags & 1);
+        if (!(raw ? copyEntryRaw(modZip, into, info) : copyEntry(modZip, into)))
             return false;
-        }
-        if (!JlCompress::copyData(fileInsideMod, zipOutFile)) {
-            zipOutFile.close();
-            fileInsideMod.close();
-            qCritical() << "Failed to copy data of " << filename << " into the jar";
-            return false;
-        }
-        zipOutFile.close();
-        fileInsideMod.close();
     }
+    if (skipped > 0)
+        qDebug() << "Skipped" << skipped << "filtered or already contained files from" << from.fileName();
     return true;
 }
 
@@ -248,6 +305,29 @@ QString findFolderOfFileInZip(QuaZip* zip, const QString& what, const QStringLis
     return {};
 }
 
+QString findFolderOfFileInZip(const QStringList& names, const QString& what, const QStringList& ignore_paths)
+{
+    QString found;
+    int found_depth = -1;
+    for (auto& name : names) {
+        if (name != what && !name.endsWith('/' + what))
+            continue;
+
+        auto folders = name.split('/');
+        folders.removeLast();
+        if (found_depth != -1 && folders.size() >= found_depth)
+            continue;
+        auto ignored = [&ignore_paths](const QString& folder) { return ignore_paths.contains(folder + '/'); };
+        if (std::any_of(folders.cbegin(), folders.cend(), ignored))
+            continue;
+
+        found = name;
+        found.chop(what.size());
+        found_depth = folders.size();
+    }
+    return found;
+}
+
 // ours
 bool findFilesInZip(QuaZip* zip, const QString& what, QStringList& result, const QString& root)
 {
@@ -429,6 +509,88 @@ bool collectFileListRecursively(const QString& rootDir, const QString& subDir, Q
 }
 
 #if defined(LAUNCHER_APPLICATION)
+namespace {
+// formats that are compressed already, deflating them again costs time and saves next to nothing
+const QStringList compressedSuffixes{ "jar", "zip", "litemod", "mrpack", "png", "jpg", "jpeg", "webp", "ogg", "mp3", "gz", "xz", "7z" };
+
+bool isCompressed(QString fileName)
+{
+    if (fileName.endsWith(".disabled"))
+        fileName.chop(9);
+    return compressedSuffixes.contains(QFileInfo(fileName).suffix().toLower());
+}
+
+// Files up to this size are compressed in memory on the workers, bigger ones are streamed into the archive by the writer.
+// The workers don't get ahead of the writer by more than the second one.
+constexpr qint64 maxBufferedFile = 32 * 1024 * 1024;
+constexpr qint64 maxBufferedTotal = 256 * 1024 * 1024;
+
+struct CompressedEntry {
+    QByteArray data;
+    quint32 crc = 0;
+    qint64 size = 0;
+    bool ok = false;
+};
+
+// Reads a whole file and compresses it the way it's stored in a zip: raw deflate, no headers
+CompressedEntry compressEntry(const QString& path, int method, int level)
+{
+    CompressedEntry entry;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return entry;
+    auto data = file.readAll();
+    if (file.error() != QFileDevice::NoError)
+        return entry;
+
+    entry.size = data.size();
+    entry.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.constData()), static_cast<uInt>(data.size()));
+    if (method != Z_DEFLATED) {
+        entry.data = data;
+        entry.ok = true;
+        return entry;
+    }
+
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+        return entry;
+    entry.data.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(data.size()))));
+    stream.next_in = reinterpret_cast<Bytef*>(data.data());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(entry.data.data());
+    stream.avail_out = static_cast<uInt>(entry.data.size());
+    entry.ok = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+    entry.data.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return entry;
+}
+
+bool writeCompressedEntry(QuaZip* zip, const QString& name, const QString& source, const CompressedEntry& entry, int method, int level)
+{
+    QuaZipNewInfo info(name, source);
+    info.uncompressedSize = entry.size;
+    QuaZipFile out(zip);
+    if (!out.open(QIODevice::WriteOnly, info, nullptr, entry.crc, method, level, true))
+        return false;
+    bool written = out.write(entry.data) == entry.data.size();
+    out.close();
+    return written && out.getZipError() == 0;
+}
+
+bool writeStreamedEntry(QuaZip* zip, const QString& name, const QString& source, int method, int level)
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    QuaZipFile out(zip);
+    if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo(name, source), nullptr, 0, method, level))
+        return false;
+    bool copied = JlCompress::copyData(in, out);
+    out.close();
+    return copied && out.getZipError() == 0;
+}
+}  // namespace
+
 void ExportToZipTask::executeTask()
 {
     setStatus("Adding files...");
@@ -447,39 +609,101 @@ auto ExportToZipTask::exportZip() -> ZipResult
         return ZipResult(tr("Could not create file"));
     }
 
+    const int method = m_compression_level == 0 ? 0 : Z_DEFLATED;
     for (auto fileName : m_extra_files.keys()) {
         if (m_build_zip_future.isCanceled())
             return ZipResult();
         QuaZipFile indexFile(&m_output);
-        if (!indexFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName))) {
+        if (!indexFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName), nullptr, 0, method, m_compression_level)) {
             return ZipResult(tr("Could not create:") + fileName);
         }
         indexFile.write(m_extra_files[fileName]);
     }
 
-    for (const QFileInfo& file : m_files) {
+    // a pool of its own, so the writer never waits on workers queued behind itself
+    QThreadPool workers;
+    auto result = addFiles(workers);
+    // what wasn't started yet isn't needed anymore
+    workers.clear();
+    if (result.has_value() || m_build_zip_future.isCanceled())
+        return result;
+
+    m_output.close();
+    if (m_output.getZipError() != 0) {
+        return ZipResult(tr("A zip error occurred"));
+    }
+    return ZipResult();
+}
+
+auto ExportToZipTask::addFiles(QThreadPool& workers) -> ZipResult
+{
+    struct PendingFile {
+        QString relative;
+        QString absolute;
+        int method;
+        int level;
+        bool excluded = false;
+        // compressed in memory by the workers, streamed in by the writer otherwise
+        bool inMemory = false;
+        qint64 size = 0;
+        QFuture<CompressedEntry> entry;
+    };
+    std::deque<PendingFile> pending;
+    qint64 buffered = 0;
+    const int maxPending = workers.maxThreadCount() * 2;
+
+    int next = 0;
+    while (next < m_files.size() || !pending.empty()) {
+        // keep the workers busy with what comes after the file being written
+        while (next < m_files.size() && static_cast<int>(pending.size()) < maxPending && buffered < maxBufferedTotal) {
+            const QFileInfo& file = m_files[next++];
+
+            PendingFile item;
+            item.absolute = file.absoluteFilePath();
+            item.relative = m_dir.relativeFilePath(item.absolute);
+            item.excluded = m_exclude_files.contains(item.relative);
+            if (m_follow_symlinks) {
+                if (file.isSymLink())
+                    item.absolute = file.symLinkTarget();
+                else
+                    item.absolute = file.canonicalFilePath();
+            }
+
+            const bool store = m_compression_level == 0 || isCompressed(item.relative);
+            item.method = store ? 0 : Z_DEFLATED;
+            item.level = store ? 0 : m_compression_level;
+
+            item.size = QFileInfo(item.absolute).size();
+            if (!item.excluded && item.size <= maxBufferedFile) {
+                item.inMemory = true;
+                item.entry = QtConcurrent::run(&workers, compressEntry, item.absolute, item.method, item.level);
+                buffered += item.size;
+            }
+            pending.push_back(std::move(item));
+        }
+
         if (m_build_zip_future.isCanceled())
             return ZipResult();
 
-        auto absolute = file.absoluteFilePath();
-        auto relative = m_dir.relativeFilePath(absolute);
-        setStatus("Compresing: " + relative);
+        auto item = std::move(pending.front());
+        pending.pop_front();
+        setStatus("Compresing: " + item.relative);
         setProgress(m_progress + 1, m_progressTotal);
-        if (m_follow_symlinks) {
-            if (file.isSymLink())
-                absolute = file.symLinkTarget();
-            else
-                absolute = file.canonicalFilePath();
-        }
+        if (item.excluded)
+            continue;
 
-        if (!m_exclude_files.contains(relative) && !JlCompress::compressFile(&m_output, absolute, m_destination_prefix + relative)) {
-            return ZipResult(tr("Could not read and compress %1").arg(relative));
+        auto name = m_destination_prefix + item.relative;
+        bool added;
+        if (item.inMemory) {
+            auto entry = item.entry.result();
+            buffered -= item.size;
+            added = entry.ok && writeCompressedEntry(&m_output, name, item.absolute, entry, item.method, item.level);
+        } else {
+            added = writeStreamedEntry(&m_output, name, item.absolute, item.method, item.level);
+        }
+        if (!added) {
+            return ZipResult(tr("Could not read and compress %1").arg(item.relative));
         }
-    }
-
-    m_output.close();
-    if (m_output.getZipError() != 0) {
-        return ZipResult(tr("A zip error occurred"));
     }
     return ZipResult();
 }
@@ -507,6 +731,236 @@ bool ExportToZipTask::abort()
     }
     return false;
 }
+
+namespace {
+// The entries are handed out to the workers in runs of about this size, counting every file as at least 'extractEntryCost' bytes,
+// since creating lots of small files takes a while too
+constexpr qint64 minExtractChunk = 1024 * 1024;
+constexpr qint64 maxExtractChunk = 64 * 1024 * 1024;
+constexpr qint64 extractEntryCost = 64 * 1024;
+
+struct ExtractEntry {
+    // in the central directory
+    int index;
+    QString name;
+    QString target;
+    qint64 size;
+    bool symlink;
+};
+
+struct ExtractChunk {
+    int begin;
+    int end;
+};
+
+// Inflates the current entry of 'zip' into 'target', counting the bytes written in 'extracted' as they are
+bool extractEntry(QuaZip& zip, const ExtractEntry& entry, QByteArray& buffer, std::atomic<qint64>& extracted)
+{
+    if (entry.symlink) {
+        // the entry holds the path the link points to, which JlCompress knows how to turn into a link
+        if (!JlCompress::extractFile(&zip, "", entry.target))
+            return false;
+        extracted += entry.size;
+        return true;
+    }
+
+    QuaZipFile in(&zip);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    QFile out(entry.target);
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+    // sized up front, so the file system can lay it out in one go instead of growing it with every write
+    if (entry.size > 0 && !out.resize(entry.size))
+        return false;
+
+    qint64 written = 0;
+    qint64 read;
+    while ((read = in.read(buffer.data(), buffer.size())) > 0) {
+        if (written + read > entry.size || out.write(buffer.constData(), read) != read)
+            return false;
+        written += read;
+        extracted += read;
+    }
+    in.close();
+    out.close();
+    // closing the entry checks its CRC
+    if (read != 0 || written != entry.size || in.getZipError() != 0 || out.error() != QFileDevice::NoError)
+        return false;
+
+    // same as extractSubDir, some packs ship scripts and binaries that have to stay runnable
+    QFile::setPermissions(entry.target, QFileDevice::ReadUser | QFileDevice::WriteUser | QFileDevice::ExeUser);
+    return true;
+}
+}  // namespace
+
+void ExtractZipTask::executeTask()
+{
+    setStatus(tr("Extracting files..."));
+    m_cancelled = false;
+    m_zip_future = QtConcurrent::run(QThreadPool::globalInstance(), [this]() { return extractZip(); });
+    connect(&m_zip_watcher, &QFutureWatcher<ZipResult>::finished, this, &ExtractZipTask::finish);
+    m_zip_watcher.setFuture(m_zip_future);
+}
+
+auto ExtractZipTask::extractZip() -> ZipResult
+{
+    if (m_entries.isEmpty()) {
+        QuaZip zip(m_archive_path);
+        if (!zip.open(QuaZip::mdUnzip)) {
+            return ZipResult(tr("Could not open %1").arg(m_archive_path));
+        }
+        m_entries = zip.getFileInfoList64();
+        if (zip.getZipError() != 0) {
+            return ZipResult(tr("Could not read the contents of %1").arg(m_archive_path));
+        }
+    }
+
+    auto target = m_output_dir.absolutePath();
+    auto target_top_dir = QUrl::fromLocalFile(target);
+
+    // everything is checked, and every folder made, before a single file is written
+    QVector<ExtractEntry> files;
+    QSet<QString> folders;
+    for (int i = 0; i < m_entries.size(); i++) {
+        const auto& info = m_entries[i];
+        if (!info.name.startsWith(m_subdirectory))
+            continue;
+
+        auto relative = QDir::fromNativeSeparators(info.name.mid(m_subdirectory.size()));
+        if (relative.startsWith('/'))
+            relative = relative.mid(1);
+        if (relative.isEmpty())
+            continue;
+
+        auto path = FS::PathCombine(target, relative);
+        if (path != target && !target_top_dir.isParentOf(QUrl::fromLocalFile(path))) {
+            return ZipResult(
+                tr("Extracting %1 was cancelled, because it was effectively outside of the target path %2").arg(relative, target));
+        }
+
+        if (relative.endsWith('/')) {
+            folders.insert(path);
+        } else {
+            folders.insert(QFileInfo(path).absolutePath());
+            files.append({ i, info.name, path, static_cast<qint64>(info.uncompressedSize), info.isSymbolicLink() });
+        }
+    }
+
+    // a name can be in an archive more than once, and like with unzip, the last one is what ends up on disk
+    QHash<QString, int> last_of_target;
+    for (int i = 0; i < files.size(); i++)
+        last_of_target.insert(files[i].target, i);
+    if (last_of_target.size() != files.size()) {
+        QVector<ExtractEntry> unique;
+        unique.reserve(last_of_target.size());
+        for (int i = 0; i < files.size(); i++) {
+            if (last_of_target.value(files[i].target) == i)
+                unique.append(files[i]);
+        }
+        files = unique;
+    }
+    for (auto& folder : folders) {
+        if (!FS::ensureFolderPathExists(folder)) {
+            return ZipResult(tr("Could not create folder %1").arg(folder));
+        }
+    }
+
+    qint64 total = 0;
+    for (auto& file : files)
+        total += file.size;
+
+    const int threads = std::max(1, m_max_threads);
+    const qint64 chunk_size = std::clamp((total + files.size() * extractEntryCost) / (threads * 4), minExtractChunk, maxExtractChunk);
+    QVector<ExtractChunk> chunks;
+    qint64 chunk_used = 0;
+    for (int i = 0; i < files.size(); i++) {
+        if (chunks.isEmpty() || chunk_used >= chunk_size) {
+            chunks.append({ i, i });
+            chunk_used = 0;
+        }
+        chunks.last().end = i + 1;
+        chunk_used += std::max(files[i].size, extractEntryCost);
+    }
+
+    std::atomic<int> next_chunk{ 0 };
+    std::atomic<qint64> extracted{ 0 };
+    std::atomic<bool> failed{ false };
+    auto worker = [&]() -> ZipResult {
+        // every worker reads the archive through a handle of its own
+        QuaZip zip(m_archive_path);
+        if (!zip.open(QuaZip::mdUnzip) || !zip.goToFirstFile()) {
+            failed = true;
+            return ZipResult(tr("Could not open %1").arg(m_archive_path));
+        }
+        int current = 0;
+        QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+        for (int chunk; (chunk = next_chunk++) < chunks.size();) {
+            for (int i = chunks[chunk].begin; i < chunks[chunk].end; i++) {
+                if (failed || m_cancelled)
+                    return ZipResult();
+
+                const auto& file = files[i];
+                // the chunks are taken in order, so the worker only ever walks forward through the archive
+                bool found = true;
+                for (; found && current < file.index; current++)
+                    found = zip.goToNextFile();
+                if (!found || zip.getCurrentFileName() != file.name || !extractEntry(zip, file, buffer, extracted)) {
+                    failed = true;
+                    return ZipResult(tr("Failed to extract file %1 to %2").arg(file.name, file.target));
+                }
+            }
+        }
+        return ZipResult();
+    };
+
+    // a pool of its own, so the workers never wait on whatever else the global one is busy with
+    QThreadPool workers;
+    workers.setMaxThreadCount(std::max(1, std::min(threads, static_cast<int>(chunks.size()))));
+    QList<QFuture<ZipResult>> results;
+    for (int i = 0; i < workers.maxThreadCount(); i++)
+        results.append(QtConcurrent::run(&workers, worker));
+
+    setProgress(0, total);
+    while (!workers.waitForDone(100))
+        setProgress(extracted, total);
+    setProgress(extracted, total);
+
+    ZipResult result;
+    for (auto& future : results) {
+        if (auto worker_result = future.result(); worker_result.has_value()) {
+            result = worker_result;
+            break;
+        }
+    }
+    if (result.has_value() || m_cancelled) {
+        for (auto& file : files)
+            QFile::remove(file.target);
+    }
+    return result;
+}
+
+void ExtractZipTask::finish()
+{
+    if (auto result = m_zip_future.result(); result.has_value()) {
+        emitFailed(result.value());
+    } else if (m_cancelled) {
+        emitAborted();
+    } else {
+        emitSucceeded();
+    }
+}
+
+bool ExtractZipTask::abort()
+{
+    if (m_zip_future.isRunning()) {
+        // the future itself isn't cancelled, so it always carries a result
+        m_cancelled = true;
+        // NOTE: like with ExportToZipTask, `emitAborted()` is done once the extraction actually stops
+        return true;
+    }
+    return false;
+}
 #endif
 
 }  // namespace MMCZip
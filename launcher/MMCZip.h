@@ -45,6 +45,9 @@
 #include <QHash>
 #include <QSet>
 #include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -97,6 +100,16 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
  */
 QString findFolderOfFileInZip(QuaZip* zip, const QString& what, const QStringList& ignore_paths = {}, const QString& root = QString(""));
 
+/**
+ * Find a single file by file name (not path) in the list of the names of everything in an archive
+ * The shallowest match wins, ties go to whichever comes first in the archive.
+ *
+ * \param ignore_paths folders, at any depth, to skip
+ *
+ * \return the path prefix where the file is, a null string if there's none
+ */
+QString findFolderOfFileInZip(const QStringList& names, const QString& what, const QStringList& ignore_paths = {});
+
 /**
  * Find a multiple files of the same name in archive by file name
  * If a file is found in a path, no deeper paths are searched
@@ -171,6 +184,8 @@ class ExportToZipTask : public Task {
 
     void setExcludeFiles(QStringList excludeFiles) { m_exclude_files = excludeFiles; }
     void addExtraFile(QString fileName, QByteArray data) { m_extra_files.insert(fileName, data); }
+    /* 0 (store everything) to 9 (smallest), files in formats that are compressed already are always stored */
+    void setCompressionLevel(int level) { m_compression_level = level; }
 
     using ZipResult = std::optional<QString>;
 
@@ -179,6 +194,8 @@ class ExportToZipTask : public Task {
     bool abort() override;
 
     ZipResult exportZip();
+    // compresses the files on 'workers', and adds them to the archive in order
+    ZipResult addFiles(QThreadPool& workers);
     void finish();
 
    private:
@@ -190,9 +207,49 @@ class ExportToZipTask : public Task {
     bool m_follow_symlinks;
     QStringList m_exclude_files;
     QHash<QString, QByteArray> m_extra_files;
+    int m_compression_level = Z_DEFAULT_COMPRESSION;
 
     QFuture<ZipResult> m_build_zip_future;
     QFutureWatcher<ZipResult> m_build_zip_watcher;
 };
+
+/**
+ * Extracts a subdirectory of an archive, several entries at a time.
+ * The progress is in bytes of the extracted files.
+ */
+class ExtractZipTask : public Task {
+   public:
+    ExtractZipTask(QString archivePath, QDir outputDir, QString subdirectory = "")
+        : m_archive_path(archivePath), m_output_dir(outputDir), m_subdirectory(subdirectory)
+    {
+        setAbortable(true);
+    }
+    virtual ~ExtractZipTask() = default;
+
+    /* The central directory of the archive, when it was read already. Otherwise, the task reads it itself. */
+    void setEntries(QList<QuaZipFileInfo64> entries) { m_entries = entries; }
+    void setMaxThreads(int threads) { m_max_threads = threads; }
+
+    using ZipResult = std::optional<QString>;
+
+   protected:
+    virtual void executeTask() override;
+    bool abort() override;
+
+    ZipResult extractZip();
+    void finish();
+
+   private:
+    QString m_archive_path;
+    QDir m_output_dir;
+    QString m_subdirectory;
+    QList<QuaZipFileInfo64> m_entries;
+    int m_max_threads = QThread::idealThreadCount();
+
+    QFuture<ZipResult> m_zip_future;
+    QFutureWatcher<ZipResult> m_zip_watcher;
+    // set by abort(), the workers check it between entries
+    std::atomic_bool m_cancelled{ false };
+};
 #endif
 }  // namespace MMCZip
@@ -22,6 +22,11 @@ MessageLevel::Enum MessageLevel::getLevel(const QString& levelName)
         return MessageLevel::Unknown;
 }
 
+bool MessageLevel::isUndetermined(MessageLevel::Enum level)
+{
+    return level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown;
+}
+
 MessageLevel::Enum MessageLevel::fromLine(QString& line)
 {
     // Level prefix
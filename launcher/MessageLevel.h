@@ -21,6 +21,9 @@ enum Enum {
 };
 MessageLevel::Enum getLevel(const QString& levelName);
 
+/* Whether the level still has to be guessed from the line contents. */
+bool isUndetermined(MessageLevel::Enum level);
+
 /* Get message level from a line. Line is modified if it was successful. */
 MessageLevel::Enum fromLine(QString& line);
 }  // namespace MessageLevel
@@ -20,11 +20,16 @@
 #include "ResourceDownloadTask.h"
 
 #include "Application.h"
+#include "ContentStore.h"
+
+#include <QtConcurrentRun>
 
 #include "minecraft/mod/ModFolderModel.h"
 #include "minecraft/mod/ResourceFolderModel.h"
 
+#include "modplatform/helpers/HashUtils.h"
 #include "net/ApiDownload.h"
+#include "tasks/MultipleOptionsTask.h"
 
 ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
                                            ModPlatform::IndexedVersion version,
@@ -53,18 +58,44 @@ ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
         }
     }
 
-    m_filesNetJob->addNetAction(Net::ApiDownload::makeFile(m_pack_version.downloadUrl, dir.absoluteFilePath(getFilename())));
+    m_target_path = dir.absoluteFilePath(getFilename());
+    m_filesNetJob->addNetAction(Net::ApiDownload::makeFile(m_pack_version.downloadUrl, m_target_path));
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, &ResourceDownloadTask::downloadSucceeded);
     connect(m_filesNetJob.get(), &NetJob::progress, this, &ResourceDownloadTask::downloadProgressChanged);
     connect(m_filesNetJob.get(), &NetJob::stepProgress, this, &ResourceDownloadTask::propagateStepProgress);
     connect(m_filesNetJob.get(), &NetJob::failed, this, &ResourceDownloadTask::downloadFailed);
 
-    addTask(m_filesNetJob);
+    // Another instance already has this exact file, so only download it if that copy can't be shared after all
+    auto store = APPLICATION->contentStore();
+    if (store && !store->find(m_pack_version.hash_type, m_pack_version.hash).isEmpty()) {
+        auto reuse_task = makeShared<ContentStoreMaterializeTask>(store, m_pack_version.hash_type, m_pack_version.hash, m_target_path);
+        connect(reuse_task.get(), &Task::succeeded, this, &ResourceDownloadTask::removeOldResource);
+
+        auto options = makeShared<MultipleOptionsTask>(nullptr, tr("Resource download"));
+        options->addTask(reuse_task);
+        options->addTask(m_filesNetJob);
+        addTask(options);
+    } else {
+        addTask(m_filesNetJob);
+    }
 }
 
 void ResourceDownloadTask::downloadSucceeded()
 {
     m_filesNetJob.reset();
+
+    // Share the new file with the instances that get it later on
+    if (auto store = APPLICATION->contentStore(); store && ContentStore::supports(m_pack_version.hash_type)) {
+        QtConcurrent::run(Hashing::pool(), [store, path = m_target_path, type = m_pack_version.hash_type, hash = m_pack_version.hash] {
+            store->add(path, type, hash);
+        });
+    }
+
+    removeOldResource();
+}
+
+void ResourceDownloadTask::removeOldResource()
+{
     auto name = std::get<0>(to_delete);
     auto filename = std::get<1>(to_delete);
     if (!name.isEmpty() && filename != m_pack_version.fileName) {
@@ -48,6 +48,7 @@ class ResourceDownloadTask : public SequentialTask {
     ModPlatform::IndexedVersion m_pack_version;
     const std::shared_ptr<ResourceFolderModel> m_pack_model;
     QString m_custom_target_folder;
+    QString m_target_path;
 
     NetJob::Ptr m_filesNetJob;
     LocalModUpdateTask::Ptr m_update_task;
@@ -55,6 +56,7 @@ class ResourceDownloadTask : public SequentialTask {
     void downloadProgressChanged(qint64 current, qint64 total);
     void downloadFailed(QString reason);
     void downloadSucceeded();
+    void removeOldResource();
 
     std::tuple<QString, QString> to_delete{ "", "" };
 
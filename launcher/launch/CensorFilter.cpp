@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CensorFilter.h"
+
+#include <algorithm>
+#include <queue>
+
+CensorFilter::CensorFilter(const QMap<QString, QString>& filter)
+{
+    m_nodes.emplace_back();
+
+    // build the trie of all keys
+    for (auto iter = filter.begin(); iter != filter.end(); iter++) {
+        const auto& key = iter.key();
+        if (key.isEmpty()) {
+            continue;
+        }
+        int node = 0;
+        for (auto qc : key) {
+            char16_t c = qc.unicode();
+            int next = child(node, c);
+            if (next == -1) {
+                next = static_cast<int>(m_nodes.size());
+                auto& children = m_nodes[node].next;
+                auto pos = std::lower_bound(children.begin(), children.end(), std::make_pair(c, 0));
+                children.insert(pos, { c, next });
+                m_nodes.emplace_back();
+                m_nodes.back().depth = m_nodes[node].depth + 1;
+            }
+            node = next;
+        }
+        m_nodes[node].match = m_keyLengths.size();
+        m_keyLengths.append(key.size());
+        m_replacements.append(iter.value());
+    }
+
+    // link every node to its longest proper suffix in the trie, breadth first
+    std::queue<int> queue;
+    for (auto& [c, next] : m_nodes[0].next) {
+        queue.push(next);
+    }
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (auto& [c, next] : m_nodes[node].next) {
+            int fail = step(m_nodes[node].fail, c);
+            m_nodes[next].fail = fail;
+            // a key ending here is longer than any key that is a suffix of it
+            if (m_nodes[next].match == -1) {
+                m_nodes[next].match = m_nodes[fail].match;
+            }
+            queue.push(next);
+        }
+    }
+}
+
+int CensorFilter::child(int node, char16_t c) const
+{
+    const auto& children = m_nodes[node].next;
+    auto pos = std::lower_bound(children.begin(), children.end(), std::make_pair(c, 0));
+    if (pos != children.end() && pos->first == c) {
+        return pos->second;
+    }
+    return -1;
+}
+
+int CensorFilter::step(int node, char16_t c) const
+{
+    while (true) {
+        int next = child(node, c);
+        if (next != -1) {
+            return next;
+        }
+        if (node == 0) {
+            return 0;
+        }
+        node = m_nodes[node].fail;
+    }
+}
+
+QString CensorFilter::apply(const QString& in) const
+{
+    if (isEmpty()) {
+        return in;
+    }
+    QString out;
+    int copied = 0;
+    int node = 0;
+    // the match that starts first so far, and the longest of those starting there
+    int pending = -1;
+    int pendingStart = 0;
+    int pendingEnd = 0;
+    int i = 0;
+    while (i < in.size()) {
+        node = step(node, in.at(i).unicode());
+        i++;
+        int match = m_nodes[node].match;
+        if (match != -1) {
+            int start = i - m_keyLengths[match];
+            // starting at the same place, a match ending later is longer
+            if (pending == -1 || start <= pendingStart) {
+                pending = match;
+                pendingStart = start;
+                pendingEnd = i;
+            }
+        }
+        // once no key that is still being matched could start at or before it, nothing can replace the pending match
+        if (pending != -1 && (i - m_nodes[node].depth > pendingStart || i == in.size())) {
+            if (out.isNull()) {
+                out.reserve(in.size());
+            }
+            out.append(in.constData() + copied, pendingStart - copied);
+            out.append(m_replacements[pending]);
+            copied = pendingEnd;
+            i = pendingEnd;
+            node = 0;
+            pending = -1;
+        }
+    }
+    if (copied == 0) {
+        // nothing to censor, share the original data
+        return in;
+    }
+    out.append(in.constData() + copied, in.size() - copied);
+    return out;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Replaces private strings (tokens, ids, names) in log lines.
+ *
+ * All keys are compiled into one Aho-Corasick automaton, so a line is censored in a single scan
+ * no matter how many keys there are. Lines without any key are returned as-is without allocating.
+ * When keys overlap, the one that starts first wins, and the longest key if several start at the same place.
+ */
+class CensorFilter {
+   public:
+    CensorFilter() = default;
+    /// Maps every key to the text it is replaced with, empty keys are ignored
+    explicit CensorFilter(const QMap<QString, QString>& filter);
+
+    bool isEmpty() const { return m_keyLengths.isEmpty(); }
+
+    QString apply(const QString& in) const;
+
+   private:
+    struct Node {
+        // children sorted by character
+        std::vector<std::pair<char16_t, int>> next;
+        int fail = 0;
+        // length of the prefix of a key this node stands for
+        int depth = 0;
+        // key of the longest match ending in this node, -1 if none
+        int match = -1;
+    };
+
+    int child(int node, char16_t c) const;
+    int step(int node, char16_t c) const;
+
+   private:
+    std::vector<Node> m_nodes;
+    QList<int> m_keyLengths;
+    QStringList m_replacements;
+};
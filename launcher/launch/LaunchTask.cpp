@@ -132,17 +132,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_censorFilter = CensorFilter(filter);
 }
 
-QString LaunchTask::censorPrivateInfo(QString in)
+QString LaunchTask::censorPrivateInfo(const QString& in) const
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end()) {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_censorFilter.apply(in);
 }
 
 void LaunchTask::proceed()
@@ -206,6 +201,8 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
         m_logModel.reset(new LogModel());
         m_logModel->setMaxLines(m_instance->getConsoleMaxLines());
         m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
+        // coalesce bursts of game output into roughly one model update per frame
+        m_logModel->setFlushInterval(16);
         // FIXME: should this really be here?
         m_logModel->setOverflowMessage(tr("Stopped watching the game log because the log length surpassed %1 lines.\n"
                                           "You may have to fix your mods because the game is still logging to files and"
@@ -217,9 +214,25 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 
 void LaunchTask::onLogLines(const QStringList& lines, MessageLevel::Enum defaultLevel)
 {
-    for (auto& line : lines) {
-        onLogLine(line, defaultLevel);
+    QStringList stripped = lines;
+    QList<MessageLevel::Enum> levels;
+    levels.reserve(stripped.size());
+    for (auto& line : stripped) {
+        // if the launcher part set a log level, use it
+        auto innerLevel = MessageLevel::fromLine(line);
+        levels.append(innerLevel != MessageLevel::Unknown ? innerLevel : defaultLevel);
     }
+
+    // guess the levels that are still undetermined in one go
+    m_instance->guessLevels(stripped, levels);
+
+    // censor private user info
+    for (auto& line : stripped) {
+        line = censorPrivateInfo(line);
+    }
+
+    auto& model = *getLogModel();
+    model.append(levels, stripped);
 }
 
 void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
@@ -231,7 +244,7 @@ void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
     }
 
     // If the level is still undetermined, guess level
-    if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown) {
+    if (MessageLevel::isUndetermined(level)) {
         level = m_instance->guessLevel(line, level);
     }
 
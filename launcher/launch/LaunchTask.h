@@ -39,6 +39,7 @@
 #include <QObjectPtr.h>
 #include <QProcess>
 #include "BaseInstance.h"
+#include "CensorFilter.h"
 #include "LaunchStep.h"
 #include "LogModel.h"
 #include "LoggedProcess.h"
@@ -89,7 +90,7 @@ class LaunchTask : public Task {
    public:
     void substituteVariables(QStringList& args) const;
     void substituteVariables(QString& cmd) const;
-    QString censorPrivateInfo(QString in);
+    QString censorPrivateInfo(const QString& in) const;
 
    protected: /* methods */
     virtual void emitFailed(QString reason) override;
@@ -119,7 +120,7 @@ class LaunchTask : public Task {
     InstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
     QList<shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
+    CensorFilter m_censorFilter;
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LogClassifier.h"
+
+#include <QStringView>
+
+namespace {
+// NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
+const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+
+struct OldStyleTag {
+    QLatin1String tag;
+    int priority;
+    MessageLevel::Enum level;
+};
+
+// tags of the old Forge logger, a tag with a higher priority overrides the lower ones
+const OldStyleTag oldStyleTags[] = {
+    { QLatin1String("INFO]"), 1, MessageLevel::Message },  { QLatin1String("CONFIG]"), 1, MessageLevel::Message },
+    { QLatin1String("FINE]"), 1, MessageLevel::Message },  { QLatin1String("FINER]"), 1, MessageLevel::Message },
+    { QLatin1String("FINEST]"), 1, MessageLevel::Message }, { QLatin1String("SEVERE]"), 2, MessageLevel::Error },
+    { QLatin1String("STDERR]"), 2, MessageLevel::Error },  { QLatin1String("WARNING]"), 3, MessageLevel::Warning },
+    { QLatin1String("DEBUG]"), 4, MessageLevel::Debug },
+};
+}  // namespace
+
+LogClassifier::LogClassifier()
+    : m_log4jHeader("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]")
+    , m_stackFrame("\\s+at " + javaSymbol)
+    , m_causedBy("Caused by: " + javaSymbol)
+    , m_throwableName("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")
+    , m_moreFrames("... \\d+ more$")
+{
+    m_log4jHeader.optimize();
+    m_stackFrame.optimize();
+    m_causedBy.optimize();
+    m_throwableName.optimize();
+    m_moreFrames.optimize();
+}
+
+const LogClassifier& LogClassifier::instance()
+{
+    static const LogClassifier classifier;
+    return classifier;
+}
+
+MessageLevel::Enum LogClassifier::classify(const QString& line, MessageLevel::Enum level) const
+{
+    level = levelFromTags(line, level);
+    if (line.contains(QLatin1String("overwriting existing")))
+        return MessageLevel::Fatal;
+    if (isStackTrace(line))
+        return MessageLevel::Error;
+    return level;
+}
+
+void LogClassifier::classify(const QStringList& lines, QList<MessageLevel::Enum>& levels) const
+{
+    Q_ASSERT(lines.size() == levels.size());
+    for (int i = 0; i < lines.size(); i++) {
+        if (MessageLevel::isUndetermined(levels[i])) {
+            levels[i] = classify(lines[i], levels[i]);
+        }
+    }
+}
+
+MessageLevel::Enum LogClassifier::levelFromTags(const QString& line, MessageLevel::Enum level) const
+{
+    // New style logs from log4j, every header contains "] [" so only those lines need the regex
+    if (line.contains(QLatin1String("] ["))) {
+        auto match = m_log4jHeader.match(line);
+        if (match.hasMatch()) {
+            auto levelStr = match.captured("level");
+            if (levelStr == "INFO")
+                return MessageLevel::Message;
+            if (levelStr == "WARN")
+                return MessageLevel::Warning;
+            if (levelStr == "ERROR")
+                return MessageLevel::Error;
+            if (levelStr == "FATAL")
+                return MessageLevel::Fatal;
+            if (levelStr == "TRACE" || levelStr == "DEBUG")
+                return MessageLevel::Debug;
+            return level;
+        }
+    }
+
+    // Old style forge logs, all tags are matched in one pass over the opening brackets
+    int priority = 0;
+    const QStringView view{ line };
+    for (auto pos = line.indexOf('['); pos != -1; pos = line.indexOf('[', pos + 1)) {
+        const auto rest = view.mid(pos + 1);
+        for (const auto& tag : oldStyleTags) {
+            if (tag.priority > priority && rest.startsWith(tag.tag)) {
+                priority = tag.priority;
+                level = tag.level;
+            }
+        }
+    }
+    return level;
+}
+
+bool LogClassifier::isStackTrace(const QString& line) const
+{
+    if (line.contains(QLatin1String("Exception in thread")))
+        return true;
+    if (line.contains(QLatin1String("at ")) && m_stackFrame.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1String("Caused by: ")) && m_causedBy.match(line).hasMatch())
+        return true;
+    if (line.contains('.') &&
+        (line.contains(QLatin1String("Exception")) || line.contains(QLatin1String("Error")) || line.contains(QLatin1String("Throwable"))) &&
+        m_throwableName.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1String(" more")) && m_moreFrames.match(line).hasMatch())
+        return true;
+    return false;
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+#include "MessageLevel.h"
+
+/**
+ * @brief Guesses the level of lines printed by a Java game process.
+ *
+ * Understands log4j headers, the old Forge logger tags and Java stack traces.
+ * All patterns are compiled once; every line is first dispatched on plain substring checks,
+ * so a regular expression only runs on lines that can actually match it.
+ */
+class LogClassifier {
+   public:
+    LogClassifier();
+
+    /// Shared classifier used by the launch code
+    static const LogClassifier& instance();
+
+    /// Guess the level of a single line, `level` is returned if nothing matches
+    MessageLevel::Enum classify(const QString& line, MessageLevel::Enum level) const;
+
+    /// Guess the levels of a batch of lines in place, only undetermined levels are touched
+    void classify(const QStringList& lines, QList<MessageLevel::Enum>& levels) const;
+
+   private:
+    MessageLevel::Enum levelFromTags(const QString& line, MessageLevel::Enum level) const;
+    bool isStackTrace(const QString& line) const;
+
+   private:
+    QRegularExpression m_log4jHeader;
+    QRegularExpression m_stackFrame;
+    QRegularExpression m_causedBy;
+    QRegularExpression m_throwableName;
+    QRegularExpression m_moreFrames;
+};
@@ -3,6 +3,9 @@
 LogModel::LogModel(QObject* parent) : QAbstractListModel(parent)
 {
     m_content.resize(m_maxLines);
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogModel::flush);
 }
 
 int LogModel::rowCount(const QModelIndex& parent) const
@@ -35,6 +38,11 @@ void LogModel::append(MessageLevel::Enum level, QString line)
     if (m_suspended) {
         return;
     }
+    // keep the order of lines that are still waiting for a flush
+    if (!m_pending.isEmpty()) {
+        m_pending.append(entry{ level, line });
+        return;
+    }
     int lineNum = (m_firstLine + m_numLines) % m_maxLines;
     // overflow
     if (m_numLines == m_maxLines) {
@@ -57,6 +65,67 @@ void LogModel::append(MessageLevel::Enum level, QString line)
     endInsertRows();
 }
 
+void LogModel::append(const QList<MessageLevel::Enum>& levels, const QStringList& lines)
+{
+    Q_ASSERT(levels.size() == lines.size());
+    if (m_suspended || lines.isEmpty()) {
+        return;
+    }
+    m_pending.reserve(m_pending.size() + lines.size());
+    for (int i = 0; i < lines.size(); i++) {
+        m_pending.append(entry{ levels[i], lines[i] });
+    }
+    if (m_flushTimer.interval() == 0) {
+        flush();
+    } else if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void LogModel::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+    QVector<entry> pending;
+    pending.swap(m_pending);
+
+    int first = 0;
+    int count = pending.size();
+    if (m_stopOnOverflow) {
+        // only what still fits is kept, the last free line is taken by the overflow message
+        count = qMin(count, m_maxLines - m_numLines);
+        if (count == 0) {
+            // nothing more to do, the buffer is full
+            return;
+        }
+        if (m_numLines + count == m_maxLines) {
+            pending[count - 1] = entry{ MessageLevel::Fatal, m_overflowMessage };
+        }
+    } else {
+        // only the newest lines survive the rotation of the circular buffer
+        if (count > m_maxLines) {
+            first = count - m_maxLines;
+            count = m_maxLines;
+        }
+        int overflow = m_numLines + count - m_maxLines;
+        if (overflow > 0) {
+            beginRemoveRows(QModelIndex(), 0, overflow - 1);
+            m_firstLine = (m_firstLine + overflow) % m_maxLines;
+            m_numLines -= overflow;
+            endRemoveRows();
+        }
+    }
+
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for (int i = 0; i < count; i++) {
+        m_content[(m_firstLine + m_numLines + i) % m_maxLines] = pending[first + i];
+    }
+    m_numLines += count;
+    endInsertRows();
+}
+
 void LogModel::suspend(bool suspend)
 {
     m_suspended = suspend;
@@ -69,6 +138,8 @@ bool LogModel::suspended()
 
 void LogModel::clear()
 {
+    m_pending.clear();
+    m_flushTimer.stop();
     beginResetModel();
     m_firstLine = 0;
     m_numLines = 0;
@@ -77,6 +148,7 @@ void LogModel::clear()
 
 QString LogModel::toPlainText()
 {
+    flush();
     QString out;
     out.reserve(m_numLines * 80);
     for (int i = 0; i < m_numLines; i++) {
@@ -89,6 +161,7 @@ QString LogModel::toPlainText()
 
 void LogModel::setMaxLines(int maxLines)
 {
+    flush();
     // no-op
     if (maxLines == m_maxLines) {
         return;
@@ -138,6 +211,19 @@ void LogModel::setOverflowMessage(const QString& overflowMessage)
     m_overflowMessage = overflowMessage;
 }
 
+int LogModel::getFlushInterval() const
+{
+    return m_flushTimer.interval();
+}
+
+void LogModel::setFlushInterval(int interval)
+{
+    m_flushTimer.setInterval(interval);
+    if (interval == 0) {
+        flush();
+    }
+}
+
 void LogModel::setLineWrap(bool state)
 {
     if (m_lineWrap != state) {
@@ -2,6 +2,8 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include "MessageLevel.h"
 
 class LogModel : public QAbstractListModel {
@@ -13,6 +15,10 @@ class LogModel : public QAbstractListModel {
     QVariant data(const QModelIndex& index, int role) const;
 
     void append(MessageLevel::Enum, QString line);
+    /// Append a chunk of lines, model notifications are coalesced until the next flush
+    void append(const QList<MessageLevel::Enum>& levels, const QStringList& lines);
+    /// Push all pending lines into the model with one remove and one insert notification
+    void flush();
     void clear();
 
     void suspend(bool suspend);
@@ -25,6 +31,10 @@ class LogModel : public QAbstractListModel {
     void setStopOnOverflow(bool stop);
     void setOverflowMessage(const QString& overflowMessage);
 
+    int getFlushInterval() const;
+    /// Time in ms that chunks of lines are collected before they are flushed, 0 flushes every chunk right away
+    void setFlushInterval(int interval);
+
     void setLineWrap(bool state);
     bool wrapLines() const;
 
@@ -38,6 +48,9 @@ class LogModel : public QAbstractListModel {
 
    private: /* data */
     QVector<entry> m_content;
+    // lines appended in chunks that are not in the circular buffer yet
+    QVector<entry> m_pending;
+    QTimer m_flushTimer;
     int m_maxLines = 1000;
     // first line in the circular buffer
     int m_firstLine = 0;
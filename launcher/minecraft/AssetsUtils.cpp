@@ -34,6 +34,7 @@
  */
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -41,7 +42,11 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
-#include <QVariant>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 #include "AssetsUtils.h"
 #include "BuildConfig.h"
@@ -69,11 +74,102 @@ QSet<QString> collectPathsFromDir(QString dirPath)
         QFileInfo info(value);
         if (info.isFile()) {
             out.insert(value);
-            qDebug() << value;
         }
     }
     return out;
 }
+
+// Every object of the index once, sorted by hash so the objects of a bucket are next to each other
+std::vector<AssetObject> uniqueObjects(const AssetsIndex& index)
+{
+    std::vector<AssetObject> objects;
+    objects.reserve(index.objects.size());
+    for (auto& object : index.objects)
+        objects.push_back(object);
+
+    std::sort(objects.begin(), objects.end(), [](const AssetObject& a, const AssetObject& b) { return a.hash < b.hash; });
+    objects.erase(std::unique(objects.begin(), objects.end(), [](const AssetObject& a, const AssetObject& b) { return a.hash == b.hash; }),
+                  objects.end());
+    return objects;
+}
+
+QString bucketOf(const AssetObject& object)
+{
+    return object.hash.left(2);
+}
+
+// A bucket's modification time changes whenever an object is added to or removed from it
+QJsonObject bucketStamps(const std::vector<AssetObject>& objects, const QString& objectsDir)
+{
+    QJsonObject stamps;
+    QString last;
+    for (auto& object : objects) {
+        auto bucket = bucketOf(object);
+        if (bucket == last)
+            continue;
+        last = bucket;
+
+        QFileInfo info(FS::PathCombine(objectsDir, bucket));
+        stamps.insert(bucket, info.isDir() ? QString::number(info.lastModified().toMSecsSinceEpoch()) : QString());
+    }
+    return stamps;
+}
+
+/*
+{
+  "<sha1 of the index>": {
+    "00": "<modification time of the bucket, in ms>",
+    ...
+  },
+  ...
+}
+*/
+QString verifiedCachePath(const QString& objectsDir)
+{
+    return FS::PathCombine(objectsDir, ".verified.json");
+}
+
+QJsonObject loadVerified(const QString& objectsDir)
+{
+    QFile file(verifiedCachePath(objectsDir));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void storeVerified(const QString& sha1, const QJsonObject& stamps, const QString& objectsDir)
+{
+    if (sha1.isEmpty())
+        return;
+
+    auto verified = loadVerified(objectsDir);
+    verified.insert(sha1, stamps);
+    try {
+        FS::write(verifiedCachePath(objectsDir), QJsonDocument(verified).toJson(QJsonDocument::Compact));
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to remember the verified assets:" << e.cause();
+    }
+}
+
+// Removes the folders under root that are left empty, deepest first
+void removeEmptyDirs(const QString& root)
+{
+    QStringList dirs;
+    QDirIterator iter(root, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (iter.hasNext())
+        dirs.append(iter.next());
+
+    std::sort(dirs.begin(), dirs.end(), [](const QString& a, const QString& b) { return a.size() > b.size(); });
+    QDir rootDir(root);
+    for (auto& dir : dirs)
+        rootDir.rmdir(dir);
+}
+
+struct PendingObject {
+    QString source;
+    QString target;
+};
+
 }  // namespace
 
 namespace AssetsUtils {
@@ -110,6 +206,7 @@ bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsInd
     // Read the file and close it.
     QByteArray jsonData = file.readAll();
     file.close();
+    index.sha1 = QString::fromLatin1(QCryptographicHash::hash(jsonData, QCryptographicHash::Sha1).toHex());
 
     QJsonParseError parseError;
     QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
@@ -139,33 +236,60 @@ bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsInd
         index.mapToResources = mapToResources.toBool(false);
     }
 
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
+    // The objects come sorted by name, so they can go straight to the end of the map
+    QJsonObject objects = root.value("objects").toObject();
+    for (auto iter = objects.constBegin(); iter != objects.constEnd(); ++iter) {
+        QJsonObject nested_object = iter.value().toObject();
 
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
-        // qDebug() << iter.key();
+        AssetObject object;
+        object.hash = nested_object.value("hash").toString();
+        object.size = nested_object.value("size").toDouble();
 
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
+        index.objects.insert(index.objects.cend(), iter.key(), object);
+    }
 
-        AssetObject object;
+    return true;
+}
 
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin(); nested_iter != nested_objects.end(); ++nested_iter) {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
+QList<AssetObject> missingObjects(const AssetsIndex& index, const QString& objectsDir)
+{
+    auto objects = uniqueObjects(index);
+
+    auto stamps = bucketStamps(objects, objectsDir);
+    if (!index.sha1.isEmpty() && loadVerified(objectsDir).value(index.sha1).toObject() == stamps) {
+        qDebug() << "Assets index" << index.id << "was already verified, skipping the check";
+        return {};
+    }
 
-            if (key == "hash") {
-                object.hash = value.toString();
-            } else if (key == "size") {
-                object.size = value.toDouble();
-            }
+    QList<AssetObject> missing;
+    for (auto begin = objects.cbegin(); begin != objects.cend();) {
+        auto bucket = bucketOf(*begin);
+        auto end = std::find_if(begin, objects.cend(), [&bucket](const AssetObject& object) { return bucketOf(object) != bucket; });
+        auto bucketPath = FS::PathCombine(objectsDir, bucket);
+
+        // Listing the names doesn't stat anything, so only the objects we have get looked at one by one
+        QSet<QString> present;
+        QDirIterator iter(bucketPath, QDir::Files | QDir::Hidden);
+        while (iter.hasNext()) {
+            iter.next();
+            present.insert(iter.fileName());
         }
 
-        index.objects.insert(iter.key(), object);
+        for (auto object = begin; object != end; ++object) {
+            if (!present.contains(object->hash) || QFileInfo(FS::PathCombine(bucketPath, object->hash)).size() != object->size)
+                missing.append(*object);
+        }
+        begin = end;
     }
 
-    return true;
+    if (missing.isEmpty())
+        storeVerified(index.sha1, stamps, objectsDir);
+    return missing;
+}
+
+void markVerified(const AssetsIndex& index, const QString& objectsDir)
+{
+    storeVerified(index.sha1, bucketStamps(uniqueObjects(index), objectsDir), objectsDir);
 }
 
 // FIXME: ugly code duplication
@@ -236,40 +360,55 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
         qDebug() << "Reconstructing resources folder at" << targetPath;
     }
 
-    if (!targetPath.isNull()) {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys()) {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
-
-            QString tlk = asset_object.hash.left(2);
-
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
-                continue;
+    if (targetPath.isNull())
+        return true;
 
-            presentFiles.remove(target_path);
+    auto presentFiles = collectPathsFromDir(targetPath);
+    QList<PendingObject> pending;
+    QSet<QString> targetDirs;
+    for (auto iter = index.objects.cbegin(); iter != index.objects.cend(); ++iter) {
+        QString target_path = FS::PathCombine(targetPath, iter.key());
+        if (presentFiles.remove(target_path))
+            continue;
 
-            if (!target.exists()) {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
+        auto& hash = iter.value().hash;
+        pending.append({ FS::PathCombine(objectDir.path(), hash.left(2), hash), target_path });
+        targetDirs.insert(QFileInfo(target_path).path());
+    }
 
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+    for (auto& dir : targetDirs)
+        FS::ensureFolderPathExists(dir);
+
+    // The virtual root belongs to the launcher, but the resources folder is the instance's own and anything may write to it.
+    // Writing through a hard link there would change the shared object, which the verified index then never checks again.
+    FS::FilePlacer placer(objectDir.path(), targetPath, index.isVirtual);
+    std::atomic<int> missing{ 0 };
+    QtConcurrent::blockingMap(pending, [&placer, &missing](const PendingObject& object) {
+        if (!placer.place(object.source, object.target))
+            missing++;
+    });
+    if (!pending.isEmpty()) {
+        qDebug() << "Placed" << pending.size() << "assets:" << placer.cloned << "cloned," << placer.linked << "hard linked,"
+                 << placer.copied << "copied," << missing << "missing";
+    }
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
-            }
+    if (index.isVirtual) {
+        auto lastUsed = FS::PathCombine(targetPath, ".lastused");
+        presentFiles.remove(lastUsed);
+        try {
+            FS::write(lastUsed, QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toUtf8());
+        } catch (const FS::FileSystemException& e) {
+            qWarning() << "Failed to mark the virtual assets as used:" << e.cause();
         }
+    }
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if (removeLeftovers) {
-            for (auto& file : presentFiles) {
-                qDebug() << "Would remove" << file;
-            }
+    if (removeLeftovers && !presentFiles.isEmpty()) {
+        qDebug() << "Removing" << presentFiles.size() << "leftover assets from" << targetPath;
+        for (auto& file : presentFiles) {
+            if (!QFile::remove(file))
+                qWarning() << "Failed to remove leftover asset" << file;
         }
+        removeEmptyDirs(targetPath);
     }
     return true;
 }
@@ -280,17 +419,22 @@ NetAction::Ptr AssetObject::getDownloadAction()
 {
     QFileInfo objectFile(getLocalPath());
     if ((!objectFile.isFile()) || (objectFile.size() != size)) {
-        auto objectDL = Net::ApiDownload::makeFile(getUrl(), objectFile.filePath());
-        if (hash.size()) {
-            auto rawHash = QByteArray::fromHex(hash.toLatin1());
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
-        }
-        objectDL->setProgress(objectDL->getProgress(), size);
-        return objectDL;
+        return makeDownloadAction();
     }
     return nullptr;
 }
 
+NetAction::Ptr AssetObject::makeDownloadAction()
+{
+    auto objectDL = Net::ApiDownload::makeFile(getUrl(), getLocalPath());
+    if (hash.size()) {
+        auto rawHash = QByteArray::fromHex(hash.toLatin1());
+        objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
+    }
+    objectDL->setProgress(objectDL->getProgress(), size);
+    return objectDL;
+}
+
 QString AssetObject::getLocalPath()
 {
     return "assets/objects/" + getRelPath();
@@ -309,11 +453,8 @@ QString AssetObject::getRelPath()
 NetJob::Ptr AssetsIndex::getDownloadJob()
 {
     auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto& object : objects.values()) {
-        auto dl = object.getDownloadAction();
-        if (dl) {
-            job->addNetAction(dl);
-        }
+    for (auto& object : AssetsUtils::missingObjects(*this, "assets/objects")) {
+        job->addNetAction(object.makeDownloadAction());
     }
     if (job->size())
         return job;
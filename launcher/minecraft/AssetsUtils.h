@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <QList>
 #include <QMap>
 #include <QString>
 #include "net/NetAction.h"
@@ -25,6 +26,8 @@ struct AssetObject {
     QUrl getUrl();
     QString getLocalPath();
     NetAction::Ptr getDownloadAction();
+    /// Same as getDownloadAction, for objects already known to be missing
+    NetAction::Ptr makeDownloadAction();
 
     QString hash;
     qint64 size;
@@ -34,6 +37,8 @@ struct AssetsIndex {
     NetJob::Ptr getDownloadJob();
 
     QString id;
+    /// SHA1 of the index file the objects were loaded from
+    QString sha1;
     QMap<QString, AssetObject> objects;
     bool isVirtual = false;
     bool mapToResources = false;
@@ -43,6 +48,14 @@ struct AssetsIndex {
 namespace AssetsUtils {
 bool loadAssetsIndexJson(const QString& id, const QString& file, AssetsIndex& index);
 
+/// The objects of the index that are missing from objectsDir or have the wrong size there.
+/// Every bucket folder is listed once instead of looking up each object, and nothing is checked
+/// at all if the index was verified before and none of its buckets changed since.
+QList<AssetObject> missingObjects(const AssetsIndex& index, const QString& objectsDir);
+
+/// Remember that every object of the index is present in objectsDir, as of the buckets' current state
+void markVerified(const AssetsIndex& index, const QString& objectsDir);
+
 QDir getAssetsDir(const QString& assetsId, const QString& resourcesFolder);
 
 /// Reconstruct a virtual assets folder for the given assets ID and return the folder
@@ -95,7 +95,7 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
         return true;
     };
 
-    auto add_download = [&](QString storage, QString url, QString sha1) {
+    auto add_download = [&](QString storage, QString url, QString sha1, qint64 size) {
         if (local) {
             return check_local_file(storage);
         }
@@ -113,16 +113,18 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
         // Don't add a time limit for the libraries cache entry validity
         options |= Net::Download::Option::MakeEternal;
 
+        auto dl = Net::ApiDownload::makeCached(url, entry, options);
         if (sha1.size()) {
             auto rawSha1 = QByteArray::fromHex(sha1.toLatin1());
-            auto dl = Net::ApiDownload::makeCached(url, entry, options);
             dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawSha1));
             qDebug() << "Checksummed Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
-            out.append(dl);
         } else {
-            out.append(Net::ApiDownload::makeCached(url, entry, options));
             qDebug() << "Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
         }
+        // lets the NetJob tell the big downloads apart before they start
+        if (size > 0)
+            dl->setProgress(dl->getProgress(), size);
+        out.append(dl);
         return true;
     };
 
@@ -140,18 +142,18 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
                     if (nat32info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "32");
-                        add_download(cooked_storage, nat32info->url, nat32info->sha1);
+                        add_download(cooked_storage, nat32info->url, nat32info->sha1, nat32info->size);
                     }
                     auto nat64info = m_mojangDownloads->getDownloadInfo(nat64Classifier);
                     if (nat64info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "64");
-                        add_download(cooked_storage, nat64info->url, nat64info->sha1);
+                        add_download(cooked_storage, nat64info->url, nat64info->sha1, nat64info->size);
                     }
                 } else {
                     auto info = m_mojangDownloads->getDownloadInfo(nativeClassifier);
                     if (info) {
-                        add_download(raw_storage, info->url, info->sha1);
+                        add_download(raw_storage, info->url, info->sha1, info->size);
                     }
                 }
             } else {
@@ -160,7 +162,7 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
         } else {
             if (m_mojangDownloads->artifact) {
                 auto artifact = m_mojangDownloads->artifact;
-                add_download(raw_storage, artifact->url, artifact->sha1);
+                add_download(raw_storage, artifact->url, artifact->sha1, artifact->size);
             } else {
                 qDebug() << "Ignoring java library" << m_name.serialize() << "because it has no artifact";
             }
@@ -184,12 +186,12 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
         if (raw_storage.contains("${arch}")) {
             QString cooked_storage = raw_storage;
             QString cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
+            add_download(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString(), 0);
             cooked_storage = raw_storage;
             cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
+            add_download(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString(), 0);
         } else {
-            add_download(raw_storage, raw_dl, QString());
+            add_download(raw_storage, raw_dl, QString(), 0);
         }
     }
     return out;
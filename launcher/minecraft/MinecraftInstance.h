@@ -140,6 +140,7 @@ class MinecraftInstance : public BaseInstance {
 
     /// guess log level from a line of minecraft log
     MessageLevel::Enum guessLevel(const QString& line, MessageLevel::Enum level) override;
+    void guessLevels(const QStringList& lines, QList<MessageLevel::Enum>& levels) override;
 
     IPathMatcher::Ptr getLogFileMatcher() override;
 
@@ -40,50 +40,99 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+// bump this when the way the jar is put together changes, so older builds of it aren't reused
+constexpr int manifestVersion = 1;
+
+QJsonObject describeFile(const QFileInfo& file)
+{
+    return QJsonObject{ { "path", file.absoluteFilePath() },
+                        { "size", QString::number(file.size()) },
+                        { "lastModified", QString::number(file.lastModified().toMSecsSinceEpoch()) } };
+}
+}  // namespace
+
 void ModMinecraftJar::executeTask()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
 
-    if (!m_inst->getJarMods().size()) {
+    auto jarMods = m_inst->getJarMods();
+    if (!jarMods.size()) {
+        // the jar of a previous launch isn't of any use anymore
+        removeJar();
         emitSucceeded();
         return;
     }
-    // nuke obsolete stripped jar(s) if needed
+
     if (!FS::ensureFolderPathExists(m_inst->binRoot())) {
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
+    auto components = m_inst->getPackProfile();
+    auto profile = components->getProfile();
+    auto mainJar = profile->getMainJar();
+    QStringList jars, temp1, temp2, temp3, temp4;
+    mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
+    auto sourceJarPath = jars[0];
+
+    // the jar from the last launch is still good if it was made out of the same files
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
+    auto manifestPath = finalJarPath + ".manifest";
+    auto manifest = inputsManifest(sourceJarPath, jarMods);
+    QFile previousManifest(manifestPath);
+    if (QFileInfo(finalJarPath).isFile() && previousManifest.open(QIODevice::ReadOnly) && previousManifest.readAll() == manifest) {
+        emit logLine(tr("Reusing the custom Minecraft jar file, as its jar mods didn't change"), MessageLevel::Launcher);
+        emitSucceeded();
+        return;
+    }
+    previousManifest.close();
+
+    // nuke obsolete stripped jar(s) if needed
     if (!removeJar()) {
         emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
+        return;
     }
 
-    // create temporary modded jar, if needed
-    auto components = m_inst->getPackProfile();
-    auto profile = components->getProfile();
-    auto jarMods = m_inst->getJarMods();
-    if (jarMods.size()) {
-        auto mainJar = profile->getMainJar();
-        QStringList jars, temp1, temp2, temp3, temp4;
-        mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
-        auto sourceJarPath = jars[0];
-        if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
-            emitFailed(tr("Failed to create the custom Minecraft jar file."));
-            return;
-        }
+    if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
+        emitFailed(tr("Failed to create the custom Minecraft jar file."));
+        return;
+    }
+
+    try {
+        FS::write(manifestPath, manifest);
+    } catch (const FS::FileSystemException& e) {
+        // only means it's made again next time
+        qWarning() << "Couldn't save the manifest of the custom Minecraft jar file:" << e.cause();
     }
     emitSucceeded();
 }
 
-void ModMinecraftJar::finalize()
+QByteArray ModMinecraftJar::inputsManifest(const QString& sourceJarPath, const QList<Mod*>& jarMods)
 {
-    removeJar();
+    QJsonArray mods;
+    for (auto* mod : jarMods) {
+        auto entry = describeFile(mod->fileinfo());
+        entry.insert("enabled", mod->enabled());
+        entry.insert("type", static_cast<int>(mod->type()));
+        mods.append(entry);
+    }
+
+    QJsonObject manifest{ { "version", manifestVersion }, { "sourceJar", describeFile(QFileInfo(sourceJarPath)) }, { "jarMods", mods } };
+    return QJsonDocument(manifest).toJson(QJsonDocument::Compact);
 }
 
 bool ModMinecraftJar::removeJar()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
+    // without its jar, the manifest doesn't describe anything
+    QFile::remove(finalJarPath + ".manifest");
     QFile finalJar(finalJarPath);
     if (finalJar.exists()) {
         if (!finalJar.remove()) {
@@ -16,8 +16,11 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QList>
 #include <memory>
 
+class Mod;
+
 class ModMinecraftJar : public LaunchStep {
     Q_OBJECT
    public:
@@ -26,8 +29,9 @@ class ModMinecraftJar : public LaunchStep {
 
     virtual void executeTask() override;
     virtual bool canAbort() const override { return false; }
-    void finalize() override;
 
    private:
+    /* Describes the files the jar is made of: if none of them changed, neither did the jar */
+    static QByteArray inputsManifest(const QString& sourceJarPath, const QList<Mod*>& jarMods);
     bool removeJar();
 };
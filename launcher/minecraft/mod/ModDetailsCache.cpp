@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModDetailsCache.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "FileSystem.h"
+#include "Json.h"
+#include "minecraft/mod/tasks/LocalModParseTask.h"
+
+namespace {
+QJsonObject detailsToJson(const ModDetails& details)
+{
+    QJsonObject obj;
+    Json::writeString(obj, "mod_id", details.mod_id);
+    Json::writeString(obj, "name", details.name);
+    Json::writeString(obj, "version", details.version);
+    Json::writeString(obj, "mcversion", details.mcversion);
+    Json::writeString(obj, "homeurl", details.homeurl);
+    Json::writeString(obj, "description", details.description);
+    Json::writeStringList(obj, "authors", details.authors);
+    Json::writeString(obj, "issue_tracker", details.issue_tracker);
+    Json::writeString(obj, "icon_file", details.icon_file);
+
+    QJsonArray licenses;
+    for (auto& license : details.licenses) {
+        QJsonObject license_obj;
+        license_obj.insert("name", license.name);
+        license_obj.insert("id", license.id);
+        license_obj.insert("url", license.url);
+        license_obj.insert("description", license.description);
+        licenses.append(license_obj);
+    }
+    if (!licenses.isEmpty())
+        obj.insert("licenses", licenses);
+
+    return obj;
+}
+
+ModDetails detailsFromJson(const QJsonObject& obj)
+{
+    ModDetails details;
+    details.mod_id = Json::ensureString(obj, "mod_id");
+    details.name = Json::ensureString(obj, "name");
+    details.version = Json::ensureString(obj, "version");
+    details.mcversion = Json::ensureString(obj, "mcversion");
+    details.homeurl = Json::ensureString(obj, "homeurl");
+    details.description = Json::ensureString(obj, "description");
+    for (auto author : Json::ensureArray(obj, "authors"))
+        details.authors.append(author.toString());
+    details.issue_tracker = Json::ensureString(obj, "issue_tracker");
+    details.icon_file = Json::ensureString(obj, "icon_file");
+
+    for (auto license : Json::ensureArray(obj, "licenses")) {
+        auto license_obj = Json::ensureObject(license);
+        details.licenses.append(ModLicense(Json::ensureString(license_obj, "name"), Json::ensureString(license_obj, "id"),
+                                           Json::ensureString(license_obj, "url"), Json::ensureString(license_obj, "description")));
+    }
+
+    return details;
+}
+}  // namespace
+
+ModDetailsCache::ModDetailsCache(QString cache_file, QString folder) : m_cache_file(std::move(cache_file)), m_folder(std::move(folder))
+{
+    m_save_timer.setSingleShot(true);
+    m_save_timer.setTimerType(Qt::VeryCoarseTimer);
+    connect(&m_save_timer, &QTimer::timeout, this, &ModDetailsCache::saveNow);
+
+    load();
+}
+
+ModDetailsCache::~ModDetailsCache()
+{
+    m_save_timer.stop();
+    saveNow();
+}
+
+std::optional<ModDetails> ModDetailsCache::find(const QFileInfo& file) const
+{
+    QMutexLocker locker(&m_lock);
+
+    auto iter = m_entries.constFind(file.fileName());
+    if (iter == m_entries.constEnd())
+        return {};
+
+    if (iter->size != file.size() || iter->last_modified != file.lastModified().toMSecsSinceEpoch())
+        return {};
+
+    return iter->details;
+}
+
+void ModDetailsCache::insert(const QFileInfo& file, const ModDetails& details)
+{
+    // folders can change without their own modification time changing
+    if (!file.isFile())
+        return;
+
+    QMutexLocker locker(&m_lock);
+
+    m_entries.insert(file.fileName(), { file.size(), file.lastModified().toMSecsSinceEpoch(), details });
+    m_dirty = true;
+}
+
+void ModDetailsCache::retain(const QSet<QString>& file_names)
+{
+    QMutexLocker locker(&m_lock);
+
+    for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+        if (file_names.contains(iter.key())) {
+            iter++;
+            continue;
+        }
+        iter = m_entries.erase(iter);
+        m_dirty = true;
+    }
+}
+
+void ModDetailsCache::saveEventually()
+{
+    // reset the save timer
+    m_save_timer.stop();
+    m_save_timer.start(5000);
+}
+
+void ModDetailsCache::load()
+{
+    QFile index(m_cache_file);
+    if (!index.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parse_error;
+    auto json = QJsonDocument::fromJson(index.readAll(), &parse_error);
+    if (parse_error.error != QJsonParseError::NoError || !json.isObject()) {
+        qWarning() << "Failed to parse mod details cache" << m_cache_file << ":" << parse_error.errorString();
+        return;
+    }
+
+    auto root = json.object();
+
+    // check the versions first, details read by an older parser are thrown away
+    if (Json::ensureString(root, "version") != "1" || Json::ensureInteger(root, "parser_version", -1) != ModUtils::parserVersion) {
+        m_dirty = true;
+        return;
+    }
+
+    auto entries = Json::ensureObject(root, "entries");
+    for (auto iter = entries.begin(); iter != entries.end(); iter++) {
+        auto entry_obj = Json::ensureObject(iter.value());
+        Entry entry{ static_cast<qint64>(Json::ensureDouble(entry_obj, "size", -1)),
+                     static_cast<qint64>(Json::ensureDouble(entry_obj, "last_modified", -1)),
+                     detailsFromJson(Json::ensureObject(entry_obj, "details")) };
+        m_entries.insert(iter.key(), entry);
+    }
+}
+
+void ModDetailsCache::saveNow()
+{
+    QJsonObject entries;
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_dirty)
+            return;
+        m_dirty = false;
+
+        for (auto iter = m_entries.constBegin(); iter != m_entries.constEnd(); iter++) {
+            QJsonObject entry_obj;
+            entry_obj.insert("size", double(iter->size));
+            entry_obj.insert("last_modified", double(iter->last_modified));
+            entry_obj.insert("details", detailsToJson(iter->details));
+            entries.insert(iter.key(), entry_obj);
+        }
+    }
+
+    // don't bring a deleted folder back just to save what was in it
+    if (!m_folder.isEmpty() && !QFileInfo(m_folder).isDir()) {
+        qDebug() << "Not saving mod details cache" << m_cache_file << "because" << m_folder << "is gone";
+        return;
+    }
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "1");
+    toplevel.insert("parser_version", ModUtils::parserVersion);
+    toplevel.insert("entries", entries);
+
+    try {
+        Json::write(toplevel, m_cache_file);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to save mod details cache" << m_cache_file << ":" << e.what();
+    }
+}
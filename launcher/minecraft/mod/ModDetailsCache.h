@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+#include <memory>
+#include <optional>
+
+#include "minecraft/mod/ModDetails.h"
+
+/**
+ * @brief Persistent cache of the ModDetails parsed out of the files in one mod folder.
+ *
+ * Entries are keyed on the file name and only valid while the size and modification time of the file stay the same.
+ * The whole cache is dropped when ModUtils::parserVersion changes.
+ * Icons are not stored, ModDetails::icon_file already points into the file and icons are loaded lazily from there.
+ *
+ * find() and insert() may be called from any thread, the rest only from the thread owning the cache.
+ */
+class ModDetailsCache : public QObject {
+    Q_OBJECT
+   public:
+    using Ptr = std::shared_ptr<ModDetailsCache>;
+
+    /** 'folder' is the mod folder the cache describes, nothing is saved anymore once it's gone. */
+    explicit ModDetailsCache(QString cache_file, QString folder = {});
+    ~ModDetailsCache() override;
+
+    /** Returns the cached details of 'file', if they are still valid for it. */
+    std::optional<ModDetails> find(const QFileInfo& file) const;
+    void insert(const QFileInfo& file, const ModDetails& details);
+
+    /** Drops the entries of all files not in 'file_names'. */
+    void retain(const QSet<QString>& file_names);
+
+   public slots:
+    void saveEventually();
+    void saveNow();
+
+   private:
+    void load();
+
+   private:
+    struct Entry {
+        qint64 size;
+        qint64 last_modified;
+        ModDetails details;
+    };
+
+    QString m_cache_file;
+    QString m_folder;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+    mutable QMutex m_lock;
+
+    QTimer m_save_timer;
+};
@@ -42,6 +42,7 @@
 #include <QHeaderView>
 #include <QIcon>
 #include <QMimeData>
+#include <QPointer>
 #include <QString>
 #include <QStyle>
 #include <QThreadPool>
@@ -58,6 +59,7 @@
 #include "modplatform/ModIndex.h"
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
+#include "tasks/ThenTask.h"
 
 ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool is_indexed, bool create_dir)
     : ResourceFolderModel(QDir(dir), instance, nullptr, create_dir), m_is_indexed(is_indexed)
@@ -68,6 +70,13 @@ ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool
     m_column_resize_modes = { QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Stretch,
                               QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive };
     m_columnsHideable = { false, true, false, true, true, true };
+
+    if (m_instance) {
+        // keep the parsed details of unchanged mods across restarts, inside the mod folder so it's moved and deleted along with it.
+        // It's in a folder of its own, so saving it doesn't make the watcher of the index reload the mods.
+        auto cache_file = FS::PathCombine(indexDir().absolutePath(), ".cache", "mod_details.json");
+        m_details_cache = std::make_shared<ModDetailsCache>(cache_file, m_dir.absolutePath());
+    }
 }
 
 QVariant ModFolderModel::data(const QModelIndex& index, int role) const
@@ -193,14 +202,14 @@ int ModFolderModel::columnCount(const QModelIndex& parent) const
 Task* ModFolderModel::createUpdateTask()
 {
     auto index_dir = indexDir();
-    auto task = new ModFolderLoadTask(dir(), index_dir, m_is_indexed, m_first_folder_load);
+    auto task = new ModFolderLoadTask(dir(), index_dir, m_is_indexed, m_first_folder_load, m_details_cache);
     m_first_folder_load = false;
     return task;
 }
 
 Task* ModFolderModel::createParseTask(Resource& resource)
 {
-    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo());
+    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo(), m_details_cache);
 }
 
 bool ModFolderModel::uninstallMod(const QString& filename, bool preserve_metadata)
@@ -315,6 +324,14 @@ void ModFolderModel::onUpdateSucceeded()
 #endif
 
     applyUpdates(current_set, new_set, new_mods);
+
+    if (m_details_cache) {
+        QSet<QString> file_names;
+        for (auto& mod : new_mods)
+            file_names.insert(mod->fileinfo().fileName());
+        m_details_cache->retain(file_names);
+        m_details_cache->saveEventually();
+    }
 }
 
 void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
@@ -336,49 +353,53 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     if (result && resource)
         resource->finishResolvingWithDetails(std::move(result->details));
 
+    if (m_details_cache)
+        m_details_cache->saveEventually();
+
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
 
 static const FlameAPI flameAPI;
-bool ModFolderModel::installMod(QString file_path, ModPlatform::IndexedVersion& vers)
+Task::Ptr ModFolderModel::installMod(QString file_path, ModPlatform::IndexedVersion& vers)
 {
+    Task::Ptr metadata_task;
     if (vers.addonId.isValid()) {
-        ModPlatform::IndexedPack pack{
-            vers.addonId,
-            ModPlatform::ResourceProvider::FLAME,
-        };
-
-        QEventLoop loop;
+        auto pack = std::make_shared<ModPlatform::IndexedPack>();
+        pack->addonId = vers.addonId;
+        pack->provider = ModPlatform::ResourceProvider::FLAME;
+        auto version = std::make_shared<ModPlatform::IndexedVersion>(vers);
 
         auto response = std::make_shared<QByteArray>();
         auto job = flameAPI.getProject(vers.addonId.toString(), response);
 
-        QObject::connect(job.get(), &Task::failed, [&loop] { loop.quit(); });
-        QObject::connect(job.get(), &Task::aborted, &loop, &QEventLoop::quit);
-        QObject::connect(job.get(), &Task::succeeded, [response, this, &vers, &loop, &pack] {
+        // Without an answer from CurseForge there's nothing to write, but the mod is still installed
+        metadata_task = Tasks::afterFinished(job, [job, response, pack, version, index_dir = indexDir()]() -> Task::Ptr {
+            if (!job->wasSuccessful())
+                return nullptr;
+
             QJsonParseError parse_error{};
             QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
             if (parse_error.error != QJsonParseError::NoError) {
                 qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
                            << " reason: " << parse_error.errorString();
                 qDebug() << *response;
-                return;
+                return nullptr;
             }
             try {
                 auto obj = Json::requireObject(Json::requireObject(doc), "data");
-                FlameMod::loadIndexedPack(pack, obj);
+                FlameMod::loadIndexedPack(*pack, obj);
             } catch (const JSONValidationError& e) {
                 qDebug() << doc;
                 qWarning() << "Error while reading mod info: " << e.cause();
             }
-            LocalModUpdateTask update_metadata(indexDir(), pack, vers);
-            QObject::connect(&update_metadata, &Task::finished, &loop, &QEventLoop::quit);
-            update_metadata.start();
-        });
-
-        job->start();
 
-        loop.exec();
+            return makeShared<LocalModUpdateTask>(index_dir, *pack, *version);
+        });
     }
-    return ResourceFolderModel::installResource(file_path);
+
+    // The metadata goes first, so the mod shows up along with it when the folder is reloaded
+    return Tasks::then(metadata_task, [model = QPointer<ModFolderModel>(this), file_path] {
+        if (model)
+            model->installResource(file_path);
+    });
 }
@@ -44,6 +44,7 @@
 #include <QString>
 
 #include "Mod.h"
+#include "ModDetailsCache.h"
 #include "ResourceFolderModel.h"
 
 #include "minecraft/mod/tasks/LocalModParseTask.h"
@@ -76,7 +77,8 @@ class ModFolderModel : public ResourceFolderModel {
     [[nodiscard]] Task* createParseTask(Resource&) override;
 
     bool installMod(QString file_path) { return ResourceFolderModel::installResource(file_path); }
-    bool installMod(QString file_path, ModPlatform::IndexedVersion& vers);
+    /** Installs a mod from CurseForge, after writing its metadata. The task fails if the metadata couldn't be written. */
+    Task::Ptr installMod(QString file_path, ModPlatform::IndexedVersion& vers);
     bool uninstallMod(const QString& filename, bool preserve_metadata = false);
 
     /// Deletes all the selected mods
@@ -102,4 +104,5 @@ class ModFolderModel : public ResourceFolderModel {
    protected:
     bool m_is_indexed;
     bool m_first_folder_load = true;
+    ModDetailsCache::Ptr m_details_cache;
 };
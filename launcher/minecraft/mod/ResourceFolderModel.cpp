@@ -9,7 +9,6 @@
 #include <QMenu>
 #include <QMimeData>
 #include <QStyle>
-#include <QThreadPool>
 #include <QUrl>
 
 #include "Application.h"
@@ -33,17 +32,19 @@ ResourceFolderModel::ResourceFolderModel(QDir dir, BaseInstance* instance, QObje
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 
     connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ResourceFolderModel::directoryChanged);
-    connect(&m_helper_thread_task, &ConcurrentTask::finished, this, [this] { m_helper_thread_task.clear(); });
+    connect(&m_parse_scheduler, &ResourceParseScheduler::progress, this, &ResourceFolderModel::parseProgress);
 #ifndef LAUNCHER_TEST
     // in tests the application macro doesn't work
-    m_helper_thread_task.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    m_parse_scheduler.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
 #endif
 }
 
 ResourceFolderModel::~ResourceFolderModel()
 {
-    while (!QThreadPool::globalInstance()->waitForDone(100))
-        QCoreApplication::processEvents();
+    // Forget the tickets first, so results still queued for us are ignored while we wait on the running tasks.
+    m_active_parse_tasks.clear();
+    m_parse_scheduler.cancelAll();
+    m_parse_scheduler.waitForDone();
 }
 
 bool ResourceFolderModel::startWatching(const QStringList& paths)
@@ -286,11 +287,35 @@ void ResourceFolderModel::resolveResource(Resource* res)
     connect(
         task.get(), &Task::finished, this, [=] { m_active_parse_tasks.remove(ticket); }, Qt::ConnectionType::QueuedConnection);
 
-    m_helper_thread_task.addTask(task);
+    m_parse_scheduler.schedule(ticket, task);
+}
+
+void ResourceFolderModel::cancelResolving(Resource* res)
+{
+    if (!res->isResolving())
+        return;
+
+    auto ticket = res->resolutionTicket();
+    if (m_active_parse_tasks.remove(ticket))
+        m_parse_scheduler.cancel(ticket);
+}
 
-    if (!m_helper_thread_task.isRunning()) {
-        QThreadPool::globalInstance()->start(&m_helper_thread_task);
+void ResourceFolderModel::prioritizeRows(const QList<int>& rows)
+{
+    QList<int> tickets;
+    for (auto row : rows) {
+        if (row < 0 || row >= m_resources.size())
+            continue;
+        auto const& res = m_resources.at(row);
+        if (res->isResolving())
+            tickets.append(res->resolutionTicket());
     }
+    m_parse_scheduler.prioritize(tickets);
+}
+
+void ResourceFolderModel::setMaxParseConcurrency(int max_concurrent)
+{
+    m_parse_scheduler.setMaxConcurrent(max_concurrent);
 }
 
 void ResourceFolderModel::onUpdateSucceeded()
@@ -13,6 +13,7 @@
 #include "Resource.h"
 
 #include "BaseInstance.h"
+#include "ResourceParseScheduler.h"
 
 #include "tasks/ConcurrentTask.h"
 #include "tasks/Task.h"
@@ -77,6 +78,13 @@ class ResourceFolderModel : public QAbstractListModel {
 
     /** Creates a new parse task, if needed, for 'res' and start it.*/
     virtual void resolveResource(Resource* res);
+    /** Drops the parse task of 'res', if any, so its results are never applied. */
+    void cancelResolving(Resource* res);
+
+    /** Parses the resources at the given rows before the other pending ones, e.g. because they're visible in a view. */
+    void prioritizeRows(const QList<int>& rows);
+    /** Sets how many resources of this model may be parsed at the same time. */
+    void setMaxParseConcurrency(int max_concurrent);
 
     [[nodiscard]] qsizetype size() const { return m_resources.size(); }
     [[nodiscard]] bool empty() const { return size() == 0; }
@@ -143,6 +151,8 @@ class ResourceFolderModel : public QAbstractListModel {
 
    signals:
     void updateFinished();
+    /** Number of parse tasks done out of the ones scheduled since parsing last went idle. */
+    void parseProgress(qint64 current, qint64 total);
 
    protected:
     /** This creates a new update task to be executed by update().
@@ -217,7 +227,7 @@ class ResourceFolderModel : public QAbstractListModel {
     // Represents the relationship between a resource's internal ID and it's row position on the model.
     QMap<QString, int> m_resources_index;
 
-    ConcurrentTask m_helper_thread_task;
+    ResourceParseScheduler m_parse_scheduler;
     QMap<int, Task::Ptr> m_active_parse_tasks;
     std::atomic<int> m_next_resolution_ticket = 0;
 };
@@ -277,13 +287,7 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
 
             // If the resource is resolving, but something about it changed, we don't want to
             // continue the resolving.
-            if (current_resource->isResolving()) {
-                auto ticket = current_resource->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
-            }
+            cancelResolving(current_resource.get());
 
             m_resources[row].reset(new_resource);
             resolveResource(m_resources.at(row).get());
@@ -307,13 +311,7 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
 
             Q_ASSERT(removed_it != m_resources.end());
 
-            if ((*removed_it)->isResolving()) {
-                auto ticket = (*removed_it)->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
-            }
+            cancelResolving(removed_it->get());
 
             beginRemoveRows(QModelIndex(), removed_index, removed_index);
             m_resources.erase(removed_it);
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceParseScheduler.h"
+
+#include <QCoreApplication>
+#include <QSet>
+
+#include <algorithm>
+
+ResourceParseScheduler::ResourceParseScheduler(QObject* parent) : QObject(parent)
+{
+    m_pool.setMaxThreadCount(m_max_concurrent);
+}
+
+ResourceParseScheduler::~ResourceParseScheduler()
+{
+    cancelAll();
+    waitForDone();
+}
+
+void ResourceParseScheduler::setMaxConcurrent(int max_concurrent)
+{
+    m_max_concurrent = qMax(1, max_concurrent);
+    m_pool.setMaxThreadCount(m_max_concurrent);
+    startNext();
+}
+
+void ResourceParseScheduler::schedule(int ticket, Task::Ptr task)
+{
+    m_pending.append({ ticket, std::move(task) });
+    m_total++;
+    emit progress(m_done, m_total);
+
+    startNext();
+}
+
+void ResourceParseScheduler::prioritize(const QList<int>& tickets)
+{
+    if (m_pending.isEmpty() || tickets.isEmpty())
+        return;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    QSet<int> wanted(tickets.begin(), tickets.end());
+#else
+    QSet<int> wanted = tickets.toSet();
+#endif
+    std::stable_partition(m_pending.begin(), m_pending.end(), [&wanted](const Pending& p) { return wanted.contains(p.ticket); });
+}
+
+bool ResourceParseScheduler::cancel(int ticket)
+{
+    auto running = m_running.constFind(ticket);
+    if (running != m_running.constEnd()) {
+        // the slot is only given back once the task actually returns
+        running.value()->abort();
+        return true;
+    }
+
+    auto pending = std::find_if(m_pending.begin(), m_pending.end(), [ticket](const Pending& p) { return p.ticket == ticket; });
+    if (pending == m_pending.end())
+        return false;
+
+    m_pending.erase(pending);
+    m_done++;
+    emit progress(m_done, m_total);
+    if (isIdle())
+        m_done = m_total = 0;
+    return true;
+}
+
+void ResourceParseScheduler::cancelAll()
+{
+    m_done += m_pending.size();
+    m_pending.clear();
+
+    for (auto& task : m_running)
+        task->abort();
+
+    emit progress(m_done, m_total);
+    if (isIdle())
+        m_done = m_total = 0;
+}
+
+void ResourceParseScheduler::waitForDone()
+{
+    // Tasks may block on the main thread (e.g. to insert into the pixmap cache), so events have to keep flowing.
+    while (!m_pool.waitForDone(100))
+        QCoreApplication::processEvents();
+}
+
+void ResourceParseScheduler::startNext()
+{
+    while (m_running.size() < m_max_concurrent && !m_pending.isEmpty()) {
+        auto next = m_pending.takeFirst();
+        auto ticket = next.ticket;
+
+        connect(next.task.get(), &Task::finished, this, [this, ticket] { taskFinished(ticket); }, Qt::QueuedConnection);
+        m_running.insert(ticket, next.task);
+
+        m_pool.start(next.task.get());
+    }
+}
+
+void ResourceParseScheduler::taskFinished(int ticket)
+{
+    auto task = m_running.take(ticket);
+    if (!task)
+        return;
+
+    disconnect(task.get(), nullptr, this, nullptr);
+
+    m_done++;
+    emit progress(m_done, m_total);
+    if (isIdle())
+        m_done = m_total = 0;
+
+    startNext();
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+
+#include "tasks/Task.h"
+
+/**
+ * @brief Runs the parse tasks of one resource folder on a thread pool of its own.
+ *
+ * At most maxConcurrent() tasks run at the same time, the others wait in a queue that is served in order,
+ * except for the tasks moved to its front by prioritize(). Pending tasks can be dropped and running ones aborted
+ * through their ticket, so a model can cancel the work of resources that changed or went away.
+ *
+ * All methods must be called from the thread owning the scheduler.
+ */
+class ResourceParseScheduler : public QObject {
+    Q_OBJECT
+   public:
+    explicit ResourceParseScheduler(QObject* parent = nullptr);
+    ~ResourceParseScheduler() override;
+
+    [[nodiscard]] int maxConcurrent() const { return m_max_concurrent; }
+    void setMaxConcurrent(int max_concurrent);
+
+    /** Queues 'task' under 'ticket', it is started as soon as there's a free slot. */
+    void schedule(int ticket, Task::Ptr task);
+
+    /** Moves the pending tasks with the given tickets to the front of the queue, keeping their relative order. */
+    void prioritize(const QList<int>& tickets);
+
+    /** Drops the task with 'ticket' if it's pending, or aborts it if it's running. Returns whether the ticket was known. */
+    bool cancel(int ticket);
+    /** Drops every pending task and aborts the running ones. */
+    void cancelAll();
+
+    /** Blocks until every running task returned, processing events meanwhile since tasks may need the main thread. */
+    void waitForDone();
+
+    [[nodiscard]] bool isIdle() const { return m_pending.isEmpty() && m_running.isEmpty(); }
+    [[nodiscard]] int pendingCount() const { return m_pending.size(); }
+    [[nodiscard]] int runningCount() const { return m_running.size(); }
+
+   signals:
+    /** Number of tasks done out of the total scheduled since the scheduler was last idle. */
+    void progress(qint64 current, qint64 total);
+
+   private:
+    void startNext();
+    void taskFinished(int ticket);
+
+   private:
+    struct Pending {
+        int ticket;
+        Task::Ptr task;
+    };
+
+    QThreadPool m_pool;
+    int m_max_concurrent = 1;
+
+    QList<Pending> m_pending;
+    QHash<int, Task::Ptr> m_running;
+
+    qint64 m_done = 0;
+    qint64 m_total = 0;
+};
@@ -8,6 +8,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QSet>
 #include <QString>
 
 #include "FileSystem.h"
@@ -467,105 +468,81 @@ bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
     if (!zip.open(QuaZip::mdUnzip))
         return false;
 
-    QuaZipFile file(&zip);
+    // Walk the central directory only once. QuaZip remembers the position of every entry seen while doing so,
+    // so the lookups below are answered from this index and setCurrentFile() seeks straight to the entry.
+    // The names are matched like setCurrentFile() does by default: ignoring case where the file system does, on Windows.
+    auto entries = zip.getFileNameList();
+    const bool ignoreCase = QuaZip::convertCaseSensitivity(QuaZip::csDefault) == Qt::CaseInsensitive;
+    auto indexKey = [ignoreCase](const QString& name) { return ignoreCase ? name.toLower() : name; };
+    QSet<QString> index;
+    index.reserve(entries.size());
+    for (auto& entry : entries)
+        index.insert(indexKey(entry));
+    auto inIndex = [&index, &indexKey](const QString& name) { return index.contains(indexKey(name)); };
+
+    auto readEntry = [&zip](const QString& name, QByteArray& data) {
+        if (!zip.setCurrentFile(name))
+            return false;
+        QuaZipFile file(&zip);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        data = file.readAll();
+        file.close();
+        return true;
+    };
 
-    if (zip.setCurrentFile("META-INF/mods.toml")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    QByteArray data;
+    if (inIndex("META-INF/mods.toml")) {
+        if (!readEntry("META-INF/mods.toml", data))
             return false;
-        }
 
-        details = ReadMCModTOML(file.readAll());
-        file.close();
+        details = ReadMCModTOML(data);
 
         // to replace ${file.jarVersion} with the actual version, as needed
-        if (details.version == "${file.jarVersion}") {
-            if (zip.setCurrentFile("META-INF/MANIFEST.MF")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    zip.close();
-                    return false;
-                }
-
-                // quick and dirty line-by-line parser
-                auto manifestLines = file.readAll().split('\n');
-                QString manifestVersion = "";
-                for (auto& line : manifestLines) {
-                    if (QString(line).startsWith("Implementation-Version: ")) {
-                        manifestVersion = QString(line).remove("Implementation-Version: ");
-                        break;
-                    }
-                }
+        if (details.version == "${file.jarVersion}" && inIndex("META-INF/MANIFEST.MF")) {
+            if (!readEntry("META-INF/MANIFEST.MF", data))
+                return false;
 
-                // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
-                // also keep with forge's behavior of setting the version to "NONE" if none is found
-                if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
-                    manifestVersion = "NONE";
+            // quick and dirty line-by-line parser
+            auto manifestLines = data.split('\n');
+            QString manifestVersion = "";
+            for (auto& line : manifestLines) {
+                if (QString(line).startsWith("Implementation-Version: ")) {
+                    manifestVersion = QString(line).remove("Implementation-Version: ");
+                    break;
                 }
-
-                details.version = manifestVersion;
-
-                file.close();
             }
-        }
 
-        zip.close();
-        mod.setDetails(details);
+            // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
+            // also keep with forge's behavior of setting the version to "NONE" if none is found
+            if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
+                manifestVersion = "NONE";
+            }
 
-        return true;
-    } else if (zip.setCurrentFile("mcmod.info")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
+            details.version = manifestVersion;
         }
-
-        details = ReadMCModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("quilt.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    } else if (inIndex("mcmod.info")) {
+        if (!readEntry("mcmod.info", data))
             return false;
-        }
-
-        details = ReadQuiltModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("fabric.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+        details = ReadMCModInfo(data);
+    } else if (inIndex("quilt.mod.json")) {
+        if (!readEntry("quilt.mod.json", data))
             return false;
-        }
-
-        details = ReadFabricModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("forgeversion.properties")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+        details = ReadQuiltModInfo(data);
+    } else if (inIndex("fabric.mod.json")) {
+        if (!readEntry("fabric.mod.json", data))
             return false;
-        }
-
-        details = ReadForgeInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("META-INF/nil/mappings.json")) {
+        details = ReadFabricModInfo(data);
+    } else if (inIndex("forgeversion.properties")) {
+        if (!readEntry("forgeversion.properties", data))
+            return false;
+        details = ReadForgeInfo(data);
+    } else if (inIndex("META-INF/nil/mappings.json")) {
         // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
         // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
 
         QString foundNilMeta;
-        for (auto& fname : zip.getFileNameList()) {
+        for (auto& fname : entries) {
             // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
             if (fname.endsWith(".nilmod.css") && fname != "nilloader.nilmod.css") {
                 foundNilMeta = fname;
@@ -573,23 +550,16 @@ bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
             }
         }
 
-        if (zip.setCurrentFile(foundNilMeta)) {
-            if (!file.open(QIODevice::ReadOnly)) {
-                zip.close();
-                return false;
-            }
-
-            details = ReadNilModInfo(file.readAll(), foundNilMeta);
-            file.close();
-            zip.close();
-
-            mod.setDetails(details);
-            return true;
-        }
+        if (foundNilMeta.isEmpty() || !readEntry(foundNilMeta, data))
+            return false;
+        details = ReadNilModInfo(data, foundNilMeta);
+    } else {
+        return false;  // no valid mod found in archive
     }
 
     zip.close();
-    return false;  // no valid mod found in archive
+    mod.setDetails(details);
+    return true;
 }
 
 bool processFolder(Mod& mod, [[maybe_unused]] ProcessingLevel level)
@@ -728,8 +698,8 @@ bool loadIconFile(const Mod& mod)
 
 }  // namespace ModUtils
 
-LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile)
-    : Task(nullptr, false), m_token(token), m_type(type), m_modFile(modFile), m_result(new Result())
+LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile, ModDetailsCache::Ptr cache)
+    : Task(nullptr, false), m_token(token), m_type(type), m_modFile(modFile), m_cache(std::move(cache)), m_result(new Result())
 {}
 
 bool LocalModParseTask::abort()
@@ -740,10 +710,20 @@ bool LocalModParseTask::abort()
 
 void LocalModParseTask::executeTask()
 {
-    Mod mod{ m_modFile };
-    ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
+    std::optional<ModDetails> cached;
+    if (m_cache)
+        cached = m_cache->find(m_modFile);
+
+    if (cached) {
+        m_result->details = *cached;
+    } else {
+        Mod mod{ m_modFile };
+        ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
 
-    m_result->details = mod.details();
+        m_result->details = mod.details();
+        if (m_cache)
+            m_cache->insert(m_modFile, m_result->details);
+    }
 
     if (m_aborted)
         emit finished();
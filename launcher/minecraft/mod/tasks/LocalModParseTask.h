@@ -5,11 +5,15 @@
 
 #include "minecraft/mod/Mod.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include "tasks/Task.h"
 
 namespace ModUtils {
 
+/** Bump this whenever the parsers below change what they read, so that cached ModDetails get parsed again. */
+constexpr int parserVersion = 1;
+
 ModDetails ReadFabricModInfo(QByteArray contents);
 ModDetails ReadQuiltModInfo(QByteArray contents);
 ModDetails ReadForgeInfo(QByteArray contents);
@@ -42,7 +46,7 @@ class LocalModParseTask : public Task {
     [[nodiscard]] bool canAbort() const override { return true; }
     bool abort() override;
 
-    LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile);
+    LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile, ModDetailsCache::Ptr cache = nullptr);
     void executeTask() override;
 
     [[nodiscard]] int token() const { return m_token; }
@@ -56,6 +60,7 @@ class LocalModParseTask : public Task {
     int m_token;
     ResourceType m_type;
     QFileInfo m_modFile;
+    ModDetailsCache::Ptr m_cache;
     ResultPtr m_result;
 
     std::atomic<bool> m_aborted = false;
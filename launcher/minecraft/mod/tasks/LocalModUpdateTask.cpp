@@ -26,8 +26,8 @@
 #include <windows.h>
 #endif
 
-LocalModUpdateTask::LocalModUpdateTask(QDir index_dir, ModPlatform::IndexedPack& mod, ModPlatform::IndexedVersion& mod_version)
-    : m_index_dir(index_dir), m_mod(mod), m_mod_version(mod_version)
+LocalModUpdateTask::LocalModUpdateTask(QDir index_dir, ModPlatform::IndexedPack mod, ModPlatform::IndexedVersion mod_version)
+    : m_index_dir(index_dir), m_mod(std::move(mod)), m_mod_version(std::move(mod_version))
 {
     // Ensure a '.index' folder exists in the mods folder, and create it if it does not
     if (!FS::ensureFolderPathExists(index_dir.path())) {
@@ -28,7 +28,10 @@ class LocalModUpdateTask : public Task {
    public:
     using Ptr = shared_qobject_ptr<LocalModUpdateTask>;
 
-    explicit LocalModUpdateTask(QDir index_dir, ModPlatform::IndexedPack& mod, ModPlatform::IndexedVersion& mod_version);
+    explicit LocalModUpdateTask(QDir index_dir, ModPlatform::IndexedPack mod, ModPlatform::IndexedVersion mod_version);
+
+    /** The mod the metadata is written for, with the slug of the previous metadata filled in if it had none */
+    auto mod() const -> const ModPlatform::IndexedPack& { return m_mod; }
 
     auto canAbort() const -> bool override { return true; }
     auto abort() -> bool override;
@@ -42,6 +45,6 @@ class LocalModUpdateTask : public Task {
 
    private:
     QDir m_index_dir;
-    ModPlatform::IndexedPack& m_mod;
-    ModPlatform::IndexedVersion& m_mod_version;
+    ModPlatform::IndexedPack m_mod;
+    ModPlatform::IndexedVersion m_mod_version;
 };
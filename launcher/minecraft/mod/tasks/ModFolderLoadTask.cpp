@@ -40,12 +40,13 @@
 
 #include <QThread>
 
-ModFolderLoadTask::ModFolderLoadTask(QDir mods_dir, QDir index_dir, bool is_indexed, bool clean_orphan)
+ModFolderLoadTask::ModFolderLoadTask(QDir mods_dir, QDir index_dir, bool is_indexed, bool clean_orphan, ModDetailsCache::Ptr details_cache)
     : Task(nullptr, false)
     , m_mods_dir(mods_dir)
     , m_index_dir(index_dir)
     , m_is_indexed(is_indexed)
     , m_clean_orphan(clean_orphan)
+    , m_details_cache(std::move(details_cache))
     , m_result(new Result())
     , m_thread_to_spawn_into(thread())
 {}
@@ -106,6 +107,16 @@ void ModFolderLoadTask::executeTask()
         }
     }
 
+    // Mods that didn't change since they were last parsed don't need to be opened again
+    if (m_details_cache) {
+        for (auto mod : m_result->mods) {
+            if (mod->status() == ModStatus::NotInstalled)
+                continue;
+            if (auto details = m_details_cache->find(mod->fileinfo()))
+                mod->finishResolvingWithDetails(std::move(*details));
+        }
+    }
+
     for (auto mod : m_result->mods)
         mod->moveToThread(m_thread_to_spawn_into);
 
@@ -42,6 +42,7 @@
 #include <QRunnable>
 #include <memory>
 #include "minecraft/mod/Mod.h"
+#include "minecraft/mod/ModDetailsCache.h"
 #include "tasks/Task.h"
 
 class ModFolderLoadTask : public Task {
@@ -54,7 +55,11 @@ class ModFolderLoadTask : public Task {
     ResultPtr result() const { return m_result; }
 
    public:
-    ModFolderLoadTask(QDir mods_dir, QDir index_dir, bool is_indexed, bool clean_orphan = false);
+    ModFolderLoadTask(QDir mods_dir,
+                      QDir index_dir,
+                      bool is_indexed,
+                      bool clean_orphan = false,
+                      ModDetailsCache::Ptr details_cache = nullptr);
 
     [[nodiscard]] bool canAbort() const override { return true; }
     bool abort() override
@@ -72,6 +77,7 @@ class ModFolderLoadTask : public Task {
     QDir m_mods_dir, m_index_dir;
     bool m_is_indexed;
     bool m_clean_orphan;
+    ModDetailsCache::Ptr m_details_cache;
     ResultPtr m_result;
 
     std::atomic<bool> m_aborted = false;
@@ -28,7 +28,8 @@ EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::Resource
         return;
     connect(hash_task.get(), &Hashing::Hasher::resultsReady, [this, mod](QString hash) { m_mods.insert(hash, mod); });
     connect(hash_task.get(), &Task::failed, [this, mod] { emitFail(mod, "", RemoveFromList::No); });
-    hash_task->start();
+    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", 1));
+    m_hashing_task->addTask(hash_task);
 }
 
 EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov)
@@ -85,6 +86,17 @@ bool EnsureMetadataTask::abort()
 
 void EnsureMetadataTask::executeTask()
 {
+    // Hashing happens on the hashing pool, so if nobody ran the hashing task before us we have to wait for it
+    if (m_hashing_task && m_hashing_task->getState() == Task::State::Inactive) {
+        setStatus(tr("Hashing mods..."));
+        // a failed hash only leaves its mod out, but an abort stops us too
+        connect(m_hashing_task.get(), &Task::succeeded, this, &EnsureMetadataTask::executeTask);
+        connect(m_hashing_task.get(), &Task::failed, this, &EnsureMetadataTask::executeTask);
+        m_current_task = m_hashing_task;
+        m_hashing_task->start();
+        return;
+    }
+
     setStatus(tr("Checking if mods have metadata..."));
 
     for (auto* mod : m_mods) {
@@ -489,6 +501,16 @@ Task::Ptr EnsureMetadataTask::flameProjectsTask()
 }
 
 void EnsureMetadataTask::modrinthCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
+{
+    updateMetadata(pack, ver, mod);
+}
+
+void EnsureMetadataTask::flameCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
+{
+    updateMetadata(pack, ver, mod);
+}
+
+void EnsureMetadataTask::updateMetadata(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
 {
     // Prevent file name mismatch
     ver.fileName = mod->fileinfo().fileName();
@@ -497,20 +519,13 @@ void EnsureMetadataTask::modrinthCallback(ModPlatform::IndexedPack& pack, ModPla
 
     QDir tmp_index_dir(m_index_dir);
 
-    {
-        LocalModUpdateTask update_metadata(m_index_dir, pack, ver);
-        QEventLoop loop;
-
-        QObject::connect(&update_metadata, &Task::finished, &loop, &QEventLoop::quit);
-
-        update_metadata.start();
-
-        if (!update_metadata.isFinished())
-            loop.exec();
-    }
+    // Writing the index file is all local work that's done by the time start() returns, there's nothing to wait for
+    LocalModUpdateTask update_metadata(m_index_dir, pack, ver);
+    update_metadata.start();
+    Q_ASSERT(update_metadata.isFinished());
 
-    auto metadata = Metadata::get(tmp_index_dir, pack.slug);
-    if (!metadata.isValid()) {
+    auto metadata = Metadata::get(tmp_index_dir, update_metadata.mod().slug);
+    if (!update_metadata.wasSuccessful() || !metadata.isValid()) {
         qCritical() << "Failed to generate metadata at last step!";
         emitFail(mod);
         return;
@@ -520,42 +535,3 @@ void EnsureMetadataTask::modrinthCallback(ModPlatform::IndexedPack& pack, ModPla
 
     emitReady(mod);
 }
-
-void EnsureMetadataTask::flameCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
-{
-    try {
-        // Prevent file name mismatch
-        ver.fileName = mod->fileinfo().fileName();
-        if (ver.fileName.endsWith(".disabled"))
-            ver.fileName.chop(9);
-
-        QDir tmp_index_dir(m_index_dir);
-
-        {
-            LocalModUpdateTask update_metadata(m_index_dir, pack, ver);
-            QEventLoop loop;
-
-            QObject::connect(&update_metadata, &Task::finished, &loop, &QEventLoop::quit);
-
-            update_metadata.start();
-
-            if (!update_metadata.isFinished())
-                loop.exec();
-        }
-
-        auto metadata = Metadata::get(tmp_index_dir, pack.slug);
-        if (!metadata.isValid()) {
-            qCritical() << "Failed to generate metadata at last step!";
-            emitFail(mod);
-            return;
-        }
-
-        mod->setMetadata(metadata);
-
-        emitReady(mod);
-    } catch (Json::JsonException& e) {
-        qDebug() << e.cause();
-
-        emitFail(mod);
-    }
-}
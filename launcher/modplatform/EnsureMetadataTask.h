@@ -38,6 +38,7 @@ class EnsureMetadataTask : public Task {
     enum class RemoveFromList { Yes, No };
     void emitReady(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
     void emitFail(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
+    void updateMetadata(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod*);
 
     // Hashes and stuff
     auto createNewHash(Mod*) -> Hashing::Hasher::Ptr;
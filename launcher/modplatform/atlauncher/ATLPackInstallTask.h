@@ -119,6 +119,10 @@ class PackInstallTask : public InstanceTask {
                      const QMap<QString, QString>& toCopy);
     void install();
 
+    Task::Ptr loadComponentVersions();
+    Meta::Version::Ptr getComponentVersion(const QString& uid, const QString& version) const;
+    void onComponentVersionsLoaded(bool resetDirectory);
+
    private:
     UserInteractionSupport* m_support;
 
@@ -141,6 +145,8 @@ class PackInstallTask : public InstanceTask {
     QStringList jarmods;
     Meta::Version::Ptr minecraftVersion;
     QMap<QString, Meta::Version::Ptr> componentsToInstall;
+    /* Every component version the pack may ask for, by "uid/version", loaded before anything else */
+    QHash<QString, Meta::Version::Ptr> m_component_versions;
 
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
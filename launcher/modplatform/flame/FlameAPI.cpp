@@ -32,39 +32,16 @@ Task::Ptr FlameAPI::matchFingerprints(const QList<uint>& fingerprints, std::shar
     return netJob;
 }
 
-auto FlameAPI::getModFileChangelog(int modId, int fileId) -> QString
+Task::Ptr FlameAPI::getModFileChangelog(int modId, int fileId, std::shared_ptr<QByteArray> response) const
 {
-    QEventLoop lock;
-    QString changelog;
-
     auto netJob = makeShared<NetJob>(QString("Flame::FileChangelog"), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
     netJob->addNetAction(Net::ApiDownload::makeByteArray(
-        QString("https://api.curseforge.com/v1/mods/%1/files/%2/changelog")
-            .arg(QString::fromStdString(std::to_string(modId)), QString::fromStdString(std::to_string(fileId))),
+        QString("https://api.curseforge.com/v1/mods/%1/files/%2/changelog").arg(QString::number(modId), QString::number(fileId)),
         response));
 
-    QObject::connect(netJob.get(), &NetJob::succeeded, [&netJob, response, &changelog] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            netJob->failed(parse_error.errorString());
-            return;
-        }
-
-        changelog = Json::ensureString(doc.object(), "data");
-    });
-
-    QObject::connect(netJob.get(), &NetJob::finished, [&lock] { lock.quit(); });
+    QObject::connect(netJob.get(), &NetJob::failed, [modId, fileId] { qDebug() << "Flame API changelog failure" << modId << fileId; });
 
-    netJob->start();
-    lock.exec();
-
-    return changelog;
+    return netJob;
 }
 
 auto FlameAPI::getModDescription(int modId) -> QString
@@ -100,59 +77,6 @@ auto FlameAPI::getModDescription(int modId) -> QString
     return description;
 }
 
-auto FlameAPI::getLatestVersion(VersionSearchArgs&& args) -> ModPlatform::IndexedVersion
-{
-    auto versions_url_optional = getVersionsURL(args);
-    if (!versions_url_optional.has_value())
-        return {};
-
-    auto versions_url = versions_url_optional.value();
-
-    QEventLoop loop;
-
-    auto netJob = makeShared<NetJob>(QString("Flame::GetLatestVersion(%1)").arg(args.pack.name), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
-    ModPlatform::IndexedVersion ver;
-
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(versions_url, response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, args, &ver] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from latest mod version at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        try {
-            auto obj = Json::requireObject(doc);
-            auto arr = Json::requireArray(obj, "data");
-
-            for (auto file : arr) {
-                auto file_obj = Json::requireObject(file);
-                auto file_tmp = FlameMod::loadIndexedPackVersion(file_obj);
-                if (file_tmp.date > ver.date && (!args.loaders.has_value() || !file_tmp.loaders || args.loaders.value() & file_tmp.loaders))
-                    ver = file_tmp;
-            }
-
-        } catch (Json::JsonException& e) {
-            qCritical() << "Failed to parse response from a version request.";
-            qCritical() << e.what();
-            qDebug() << doc;
-        }
-    });
-
-    QObject::connect(netJob.get(), &NetJob::finished, [&loop] { loop.quit(); });
-
-    netJob->start();
-
-    loop.exec();
-
-    return ver;
-}
-
 Task::Ptr FlameAPI::getProjects(QStringList addonIds, std::shared_ptr<QByteArray> response) const
 {
     auto netJob = makeShared<NetJob>(QString("Flame::GetProjects"), APPLICATION->network());
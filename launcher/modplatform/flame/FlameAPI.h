@@ -12,11 +12,9 @@
 
 class FlameAPI : public NetworkResourceAPI {
    public:
-    auto getModFileChangelog(int modId, int fileId) -> QString;
+    Task::Ptr getModFileChangelog(int modId, int fileId, std::shared_ptr<QByteArray> response) const;
     auto getModDescription(int modId) -> QString;
 
-    auto getLatestVersion(VersionSearchArgs&& args) -> ModPlatform::IndexedVersion;
-
     Task::Ptr getProjects(QStringList addonIds, std::shared_ptr<QByteArray> response) const override;
     Task::Ptr matchFingerprints(const QList<uint>& fingerprints, std::shared_ptr<QByteArray> response);
     Task::Ptr getFiles(const QStringList& fileIds, std::shared_ptr<QByteArray> response) const;
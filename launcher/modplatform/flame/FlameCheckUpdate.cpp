@@ -2,7 +2,6 @@
 #include "FlameAPI.h"
 #include "FlameModIndex.h"
 
-#include <MurmurHash2.h>
 #include <memory>
 
 #include "Json.h"
@@ -12,144 +11,202 @@
 #include "minecraft/mod/ModFolderModel.h"
 #include "minecraft/mod/tasks/GetModDependenciesTask.h"
 
-#include "net/ApiDownload.h"
+#include "tasks/ConcurrentTask.h"
 
 static FlameAPI api;
 
+static bool hasUpdate(Mod* mod, const ModPlatform::IndexedVersion& latest_ver)
+{
+    return !latest_ver.hash.isEmpty() && (mod->metadata()->hash != latest_ver.hash || mod->status() == ModStatus::NotInstalled);
+}
+
+static bool isBlocked(Mod* mod, const ModPlatform::IndexedVersion& latest_ver)
+{
+    return latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id;
+}
+
+static std::optional<QJsonArray> parseDataArray(const QByteArray& response, const char* what)
+{
+    QJsonParseError parse_error{};
+    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError) {
+        qWarning() << "Error while parsing JSON response for" << what << "from FlameCheckUpdate at" << parse_error.offset
+                   << "reason:" << parse_error.errorString();
+        qWarning() << response;
+        return {};
+    }
+
+    try {
+        return Json::requireArray(Json::requireObject(doc), "data");
+    } catch (Json::JsonException& e) {
+        qWarning() << e.cause();
+        qDebug() << doc;
+        return {};
+    }
+}
+
 bool FlameCheckUpdate::abort()
 {
     m_was_aborted = true;
-    if (m_net_job)
-        return m_net_job->abort();
+    if (m_job)
+        return m_job->abort();
     return true;
 }
 
-ModPlatform::IndexedPack FlameCheckUpdate::getProjectInfo(ModPlatform::IndexedVersion& ver_info)
+/* Check for update:
+ * - Get the latest version available for every mod, a few mods at a time
+ * - Compare hash of the latest version with the current hash
+ * - Fetch whatever else is needed to report the result in bulk
+ * - If equal, no updates, else, there's updates, so add to the list
+ *
+ * Changelogs aren't fetched here, they're only loaded once somebody wants to read them.
+ * */
+void FlameCheckUpdate::executeTask()
 {
-    ModPlatform::IndexedPack pack;
+    setStatus(tr("Preparing mods for CurseForge..."));
 
-    QEventLoop loop;
+    auto versions_task =
+        makeShared<ConcurrentTask>(nullptr, "GetLatestFlameVersions", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+
+    for (auto* mod : m_mods) {
+        if (!mod->enabled()) {
+            emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
+            continue;
+        }
 
-    auto get_project_job = new NetJob("Flame::GetProjectJob", APPLICATION->network());
+        ModPlatform::IndexedPack pack;
+        pack.addonId = mod->metadata()->project_id;
+        pack.name = mod->name();
+
+        ResourceAPI::VersionSearchCallbacks callbacks;
+        callbacks.on_succeed = [this, mod](QJsonDocument& doc, ModPlatform::IndexedPack) {
+            try {
+                auto arr = Json::requireArray(Json::requireObject(doc), "data");
+                m_latest_versions.insert(mod, FlameMod::loadLatestVersion(arr, m_loaders));
+            } catch (Json::JsonException& e) {
+                qCritical() << "Failed to parse response from a version request.";
+                qCritical() << e.what();
+                qDebug() << doc;
+            }
+        };
+        callbacks.on_fail = [mod](QString const& reason, int) {
+            qWarning() << "Failed to get the versions of" << mod->name() << ":" << reason;
+        };
 
-    auto response = std::make_shared<QByteArray>();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1").arg(ver_info.addonId.toString());
-    auto dl = Net::ApiDownload::makeByteArray(url, response);
-    get_project_job->addNetAction(dl);
+        if (auto job = api.getProjectVersions({ pack, m_game_versions, m_loaders }, std::move(callbacks)))
+            versions_task->addTask(job);
+    }
 
-    QObject::connect(get_project_job, &NetJob::succeeded, [response, &pack]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
+    setStatus(tr("Getting API responses from CurseForge..."));
+    connect(versions_task.get(), &Task::progress, this, &FlameCheckUpdate::setProgress);
+    // Mods whose lookup failed have no latest version, and are reported as such along the others
+    connect(versions_task.get(), &Task::finished, this, [this] {
+        if (m_was_aborted) {
+            emitAborted();
             return;
         }
-
-        try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            FlameMod::loadIndexedPack(pack, data_obj);
-        } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
-        }
-    });
-
-    connect(get_project_job, &NetJob::failed, this, &FlameCheckUpdate::emitFailed);
-    QObject::connect(get_project_job, &NetJob::finished, [&loop, get_project_job] {
-        get_project_job->deleteLater();
-        loop.quit();
+        getDetails();
     });
 
-    get_project_job->start();
-    loop.exec();
-
-    return pack;
+    m_job = versions_task;
+    m_job->start();
 }
 
-ModPlatform::IndexedVersion FlameCheckUpdate::getFileInfo(int addonId, int fileId)
+void FlameCheckUpdate::getDetails()
 {
-    ModPlatform::IndexedVersion ver;
+    QStringList file_ids;
+    QStringList project_ids;
+    for (auto* mod : m_mods) {
+        auto latest_ver = m_latest_versions.value(mod);
+        if (!mod->enabled() || !latest_ver.addonId.isValid())
+            continue;
 
-    QEventLoop loop;
+        if (isBlocked(mod, latest_ver))
+            project_ids.append(latest_ver.addonId.toString());
+        else if (hasUpdate(mod, latest_ver) && mod->version().isEmpty() && mod->status() != ModStatus::NotInstalled)
+            file_ids.append(mod->metadata()->file_id.toString());
+    }
 
-    auto get_file_info_job = new NetJob("Flame::GetFileInfoJob", APPLICATION->network());
+    if (file_ids.isEmpty() && project_ids.isEmpty()) {
+        collectUpdates();
+        return;
+    }
 
-    auto response = std::make_shared<QByteArray>();
-    auto url = QString("https://api.curseforge.com/v1/mods/%1/files/%2").arg(QString::number(addonId), QString::number(fileId));
-    auto dl = Net::ApiDownload::makeByteArray(url, response);
-    get_file_info_job->addNetAction(dl);
+    setStatus(tr("Getting mod details from CurseForge..."));
+
+    auto details_task = makeShared<ConcurrentTask>(nullptr, "GetFlameUpdateDetails", 2);
+
+    if (!file_ids.isEmpty()) {
+        auto response = std::make_shared<QByteArray>();
+        auto job = api.getFiles(file_ids, response);
+        connect(job.get(), &Task::succeeded, this, [this, response] {
+            auto arr = parseDataArray(*response, "files");
+            if (!arr)
+                return;
+            for (auto file : *arr) {
+                try {
+                    auto file_obj = Json::requireObject(file);
+                    auto ver = FlameMod::loadIndexedPackVersion(file_obj);
+                    m_current_files.insert(ver.fileId.toString(), ver);
+                } catch (Json::JsonException& e) {
+                    qWarning() << e.cause();
+                }
+            }
+        });
+        details_task->addTask(job);
+    }
 
-    QObject::connect(get_file_info_job, &NetJob::succeeded, [response, &ver]() {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from FlameCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
+    if (!project_ids.isEmpty()) {
+        auto response = std::make_shared<QByteArray>();
+        auto job = api.getProjects(project_ids, response);
+        connect(job.get(), &Task::succeeded, this, [this, response] {
+            auto arr = parseDataArray(*response, "projects");
+            if (!arr)
+                return;
+            for (auto project : *arr) {
+                try {
+                    auto project_obj = Json::requireObject(project);
+                    ModPlatform::IndexedPack pack;
+                    FlameMod::loadIndexedPack(pack, project_obj);
+                    m_projects.insert(pack.addonId.toString(), pack);
+                } catch (Json::JsonException& e) {
+                    qWarning() << e.cause();
+                }
+            }
+        });
+        details_task->addTask(job);
+    }
 
-        try {
-            auto doc_obj = Json::requireObject(doc);
-            auto data_obj = Json::requireObject(doc_obj, "data");
-            ver = FlameMod::loadIndexedPackVersion(data_obj);
-        } catch (Json::JsonException& e) {
-            qWarning() << e.cause();
-            qDebug() << doc;
+    // Missing details only make the report a little less helpful, so failures here don't stop the check
+    connect(details_task.get(), &Task::finished, this, [this] {
+        if (m_was_aborted) {
+            emitAborted();
+            return;
         }
+        collectUpdates();
     });
-    connect(get_file_info_job, &NetJob::failed, this, &FlameCheckUpdate::emitFailed);
-    QObject::connect(get_file_info_job, &NetJob::finished, [&loop, get_file_info_job] {
-        get_file_info_job->deleteLater();
-        loop.quit();
-    });
-
-    get_file_info_job->start();
-    loop.exec();
 
-    return ver;
+    m_job = details_task;
+    m_job->start();
 }
 
-/* Check for update:
- * - Get latest version available
- * - Compare hash of the latest version with the current hash
- * - If equal, no updates, else, there's updates, so add to the list
- * */
-void FlameCheckUpdate::executeTask()
+void FlameCheckUpdate::collectUpdates()
 {
-    setStatus(tr("Preparing mods for CurseForge..."));
+    setStatus(tr("Parsing the API responses from CurseForge..."));
 
-    int i = 0;
     for (auto* mod : m_mods) {
-        if (!mod->enabled()) {
-            emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
+        if (!mod->enabled())
             continue;
-        }
-
-        setStatus(tr("Getting API response from CurseForge for '%1'...").arg(mod->name()));
-        setProgress(i++, m_mods.size());
-
-        auto latest_ver = api.getLatestVersion({ { mod->metadata()->project_id.toString() }, m_game_versions, m_loaders });
-
-        // Check if we were aborted while getting the latest version
-        if (m_was_aborted) {
-            aborted();
-            return;
-        }
-
-        setStatus(tr("Parsing the API response from CurseForge for '%1'...").arg(mod->name()));
 
+        auto latest_ver = m_latest_versions.value(mod);
         if (!latest_ver.addonId.isValid()) {
             emit checkFailed(mod, tr("No valid version found for this mod. It's probably unavailable for the current game "
                                      "version / mod loader."));
             continue;
         }
 
-        if (latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id) {
-            auto pack = getProjectInfo(latest_ver);
+        if (isBlocked(mod, latest_ver)) {
+            auto pack = m_projects.value(latest_ver.addonId.toString());
             auto recover_url = QString("%1/download/%2").arg(pack.websiteUrl, latest_ver.fileId.toString());
             emit checkFailed(mod, tr("Mod has a new update available, but is not downloadable using CurseForge."), recover_url);
 
@@ -166,20 +223,18 @@ void FlameCheckUpdate::executeTask()
             pack->authors.append({ author });
         pack->description = mod->description();
         pack->provider = ModPlatform::ResourceProvider::FLAME;
-        if (!latest_ver.hash.isEmpty() && (mod->metadata()->hash != latest_ver.hash || mod->status() == ModStatus::NotInstalled)) {
+        if (hasUpdate(mod, latest_ver)) {
             auto old_version = mod->version();
-            if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled) {
-                auto current_ver = getFileInfo(latest_ver.addonId.toInt(), mod->metadata()->file_id.toInt());
-                old_version = current_ver.version;
-            }
+            if (old_version.isEmpty() && mod->status() != ModStatus::NotInstalled)
+                old_version = m_current_files.value(mod->metadata()->file_id.toString()).version;
 
             auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver, m_mods_folder);
             m_updatable.emplace_back(pack->name, mod->metadata()->hash, old_version, latest_ver.version, latest_ver.version_type,
-                                     api.getModFileChangelog(latest_ver.addonId.toInt(), latest_ver.fileId.toInt()),
-                                     ModPlatform::ResourceProvider::FLAME, download_task);
+                                     latest_ver.changelog, ModPlatform::ResourceProvider::FLAME, download_task);
         }
         m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, latest_ver));
     }
 
+    m_job.reset();
     emitSucceeded();
 }
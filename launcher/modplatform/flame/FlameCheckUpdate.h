@@ -22,10 +22,17 @@ class FlameCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
-    ModPlatform::IndexedPack getProjectInfo(ModPlatform::IndexedVersion& ver_info);
-    ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId);
+    /* Second round: the bulk requests for what the latest versions alone don't tell us */
+    void getDetails();
+    void collectUpdates();
 
-    NetJob* m_net_job = nullptr;
+    Task::Ptr m_job;
+
+    QHash<Mod*, ModPlatform::IndexedVersion> m_latest_versions;
+    /* The files the mods are currently on, by file id, only fetched for mods missing a version string */
+    QHash<QString, ModPlatform::IndexedVersion> m_current_files;
+    /* The projects of updates that can't be downloaded, by addon id */
+    QHash<QString, ModPlatform::IndexedPack> m_projects;
 
     bool m_was_aborted = false;
 };
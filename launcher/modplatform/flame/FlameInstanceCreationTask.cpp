@@ -434,6 +434,7 @@ bool FlameCreationTask::createInstance()
         instance.setManagedPack("flame", "", name(), "", "");
 
     instance.setName(name());
+    instanceSettings->flush();
 
     m_mod_id_resolver.reset(new Flame::FileResolvingTask(APPLICATION->network(), m_pack));
     connect(m_mod_id_resolver.get(), &Flame::FileResolvingTask::succeeded, this, [this, &loop] { idResolverSucceeded(loop); });
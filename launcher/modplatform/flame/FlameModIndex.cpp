@@ -104,7 +104,7 @@ void FlameMod::loadIndexedPackVersions(ModPlatform::IndexedPack& pack,
     pack.versionsLoaded = true;
 }
 
-auto FlameMod::loadIndexedPackVersion(QJsonObject& obj, bool load_changelog) -> ModPlatform::IndexedVersion
+auto FlameMod::loadIndexedPackVersion(QJsonObject& obj) -> ModPlatform::IndexedVersion
 {
     auto versionArray = Json::requireArray(obj, "gameVersions");
     if (versionArray.isEmpty()) {
@@ -198,12 +198,25 @@ auto FlameMod::loadIndexedPackVersion(QJsonObject& obj, bool load_changelog) ->
         file.dependencies.append(dependency);
     }
 
-    if (load_changelog)
-        file.changelog = api.getModFileChangelog(file.addonId.toInt(), file.fileId.toInt());
-
     return file;
 }
 
+auto FlameMod::loadLatestVersion(QJsonArray& arr, std::optional<ModPlatform::ModLoaderTypes> loaders) -> ModPlatform::IndexedVersion
+{
+    ModPlatform::IndexedVersion ver;
+    for (auto file : arr) {
+        try {
+            auto file_obj = Json::requireObject(file);
+            auto file_tmp = loadIndexedPackVersion(file_obj);
+            if (file_tmp.date > ver.date && (!loaders.has_value() || !file_tmp.loaders || loaders.value() & file_tmp.loaders))
+                ver = file_tmp;
+        } catch (Json::JsonException& e) {
+            qWarning() << "Skipping a malformed file entry:" << e.cause();
+        }
+    }
+    return ver;
+}
+
 ModPlatform::IndexedVersion FlameMod::loadDependencyVersions(const ModPlatform::Dependency& m, QJsonArray& arr, const BaseInstance* inst)
 {
     auto profile = (dynamic_cast<const MinecraftInstance*>(inst))->getPackProfile();
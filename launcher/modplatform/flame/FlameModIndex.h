@@ -18,6 +18,8 @@ void loadIndexedPackVersions(ModPlatform::IndexedPack& pack,
                              QJsonArray& arr,
                              const shared_qobject_ptr<QNetworkAccessManager>& network,
                              const BaseInstance* inst);
-auto loadIndexedPackVersion(QJsonObject& obj, bool load_changelog = false) -> ModPlatform::IndexedVersion;
+auto loadIndexedPackVersion(QJsonObject& obj) -> ModPlatform::IndexedVersion;
+/** The newest file of a mod's file list that works with 'loaders', or an invalid version if there's none. */
+auto loadLatestVersion(QJsonArray& arr, std::optional<ModPlatform::ModLoaderTypes> loaders) -> ModPlatform::IndexedVersion;
 auto loadDependencyVersions(const ModPlatform::Dependency& m, QJsonArray& arr, const BaseInstance* inst) -> ModPlatform::IndexedVersion;
 }  // namespace FlameMod
\ No newline at end of file
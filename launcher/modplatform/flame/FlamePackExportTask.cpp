@@ -61,6 +61,7 @@ FlamePackExportTask::FlamePackExportTask(const QString& name,
 
 void FlamePackExportTask::executeTask()
 {
+    instance->settings()->flush();
     setStatus(tr("Searching for files..."));
     setProgress(0, 5);
     collectFiles();
@@ -1,10 +1,14 @@
 #include "HashUtils.h"
 
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QFile>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
-#include "FileSystem.h"
-#include "StringUtils.h"
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <MurmurHash2.h>
 
@@ -12,6 +16,173 @@ namespace Hashing {
 
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
+namespace {
+// CF-specific
+bool isCurseForgeWhitespace(char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+// Every requested QCryptographicHash, fed from the same buffer so the file is only read once
+class CryptoHashes {
+   public:
+    explicit CryptoHashes(Algorithms algorithms)
+    {
+        if (algorithms.testFlag(Algorithm::Sha1))
+            m_hashes.emplace_back(Algorithm::Sha1, std::make_unique<QCryptographicHash>(QCryptographicHash::Sha1));
+        if (algorithms.testFlag(Algorithm::Sha512))
+            m_hashes.emplace_back(Algorithm::Sha512, std::make_unique<QCryptographicHash>(QCryptographicHash::Sha512));
+        if (algorithms.testFlag(Algorithm::Md5))
+            m_hashes.emplace_back(Algorithm::Md5, std::make_unique<QCryptographicHash>(QCryptographicHash::Md5));
+    }
+
+    void addData(const char* data, qint64 size)
+    {
+        for (auto& hash : m_hashes) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+            hash.second->addData(QByteArrayView(data, size));
+#else
+            hash.second->addData(data, static_cast<int>(size));
+#endif
+        }
+    }
+
+    void results(Digests& digests) const
+    {
+        for (auto& hash : m_hashes) {
+            auto hex = QString::fromLatin1(hash.second->result().toHex());
+            switch (hash.first) {
+                case Algorithm::Sha1:
+                    digests.sha1 = hex;
+                    break;
+                case Algorithm::Sha512:
+                    digests.sha512 = hex;
+                    break;
+                case Algorithm::Md5:
+                    digests.md5 = hex;
+                    break;
+                case Algorithm::Murmur2:
+                    break;
+            }
+        }
+    }
+
+   private:
+    std::vector<std::pair<Algorithm, std::unique_ptr<QCryptographicHash>>> m_hashes;
+};
+
+// Hash cache-sized slices of a mapped file, so every digest reads the slice while it's still hot
+constexpr qint64 chunkSize = 1 * MiB;
+
+// hashFile() as something QtConcurrent::mapped can call, result_type is what Qt 5 goes by
+struct FileHasher {
+    using result_type = Digests;
+
+    Algorithms algorithms;
+
+    Digests operator()(const QString& path) const { return hashFile(path, algorithms); }
+};
+}  // namespace
+
+std::optional<Algorithm> algorithmFromName(const QString& name)
+{
+    if (name == "sha1")
+        return Algorithm::Sha1;
+    if (name == "sha512")
+        return Algorithm::Sha512;
+    if (name == "md5")
+        return Algorithm::Md5;
+    if (name == "murmur2")
+        return Algorithm::Murmur2;
+    return {};
+}
+
+QString Digests::get(Algorithm algorithm) const
+{
+    switch (algorithm) {
+        case Algorithm::Sha1:
+            return sha1;
+        case Algorithm::Sha512:
+            return sha512;
+        case Algorithm::Md5:
+            return md5;
+        case Algorithm::Murmur2:
+            return murmur2;
+    }
+    return {};
+}
+
+Digests hashFile(const QString& path, Algorithms algorithms)
+{
+    Digests digests;
+
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        digests.error = QString("Failed to open %1 for hashing: %2").arg(path, file.errorString());
+        return digests;
+    }
+
+    CryptoHashes crypto(algorithms);
+    const bool murmur2 = algorithms.testFlag(Algorithm::Murmur2);
+    const auto size = file.size();
+
+    if (auto* mapped = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr) {
+        for (qint64 offset = 0; offset < size; offset += chunkSize)
+            crypto.addData(mapped + offset, qMin(chunkSize, size - offset));
+        if (murmur2)
+            digests.murmur2 = QString::number(CurseForgeMurmurHash2(mapped, static_cast<std::size_t>(size)));
+
+        file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(mapped)));
+    } else {
+        // Can't map it (empty, special or on a weird file system), stream it instead.
+        // The murmur2 seed depends on the filtered length, so its input is kept aside until the end.
+        QByteArray buffer(static_cast<int>(chunkSize), Qt::Uninitialized);
+        QByteArray filtered;
+
+        qint64 read;
+        while ((read = file.read(buffer.data(), chunkSize)) > 0) {
+            crypto.addData(buffer.constData(), read);
+            if (murmur2) {
+                for (qint64 i = 0; i < read; i++) {
+                    if (!isCurseForgeWhitespace(buffer[i]))
+                        filtered.append(buffer[i]);
+                }
+            }
+        }
+        if (read < 0) {
+            digests.error = QString("Failed to read %1 for hashing: %2").arg(path, file.errorString());
+            return digests;
+        }
+
+        if (murmur2)
+            digests.murmur2 = QString::number(CurseForgeMurmurHash2(filtered.constData(), static_cast<std::size_t>(filtered.size())));
+    }
+
+    crypto.results(digests);
+    return digests;
+}
+
+QFuture<Digests> hashFileAsync(const QString& path, Algorithms algorithms)
+{
+    return QtConcurrent::run(pool(), [path, algorithms] { return hashFile(path, algorithms); });
+}
+
+QFuture<Digests> hashFilesAsync(const QStringList& paths, Algorithms algorithms)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QtConcurrent::mapped(pool(), paths, FileHasher{ algorithms });
+#else
+    // Qt 5 only maps on the global pool
+    return QtConcurrent::mapped(paths, FileHasher{ algorithms });
+#endif
+}
+
+QThreadPool* pool()
+{
+    static QThreadPool s_pool;
+    return &s_pool;
+}
+
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
 {
     switch (provider) {
@@ -48,24 +219,31 @@ Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvi
     return hasher;
 }
 
-void ModrinthHasher::executeTask()
+void Hasher::executeTask()
 {
-    QFile file(m_path);
+    connect(&m_watcher, &QFutureWatcher<Digests>::finished, this, &Hasher::hashFinished, Qt::UniqueConnection);
+    m_watcher.setFuture(hashFileAsync(m_path, m_algorithm));
+}
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
+bool Hasher::abort()
+{
+    if (isRunning()) {
+        m_watcher.disconnect(this);
+        emitAborted();
+    }
+    return true;
+}
 
+void Hasher::hashFinished()
+{
+    auto digests = m_watcher.result();
+    if (!digests.isValid()) {
+        qCritical() << digests.error;
         emitFailed("Failed to open file for hashing.");
         return;
     }
 
-    auto hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
-    m_hash = ProviderCaps.hash(ModPlatform::ResourceProvider::MODRINTH, &file, hash_type);
-
-    file.close();
+    m_hash = digests.get(m_algorithm);
 
     if (m_hash.isEmpty()) {
         emitFailed("Empty hash!");
@@ -75,54 +253,16 @@ void ModrinthHasher::executeTask()
     }
 }
 
-void FlameHasher::executeTask()
+ModrinthHasher::ModrinthHasher(QString file_path)
+    : Hasher(file_path, algorithmFromName(ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first()).value_or(Algorithm::Sha512))
 {
-    // CF-specific
-    auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
-
-    std::ifstream file_stream(StringUtils::toStdString(m_path).c_str(), std::ifstream::binary);
-    // TODO: This is very heavy work, but apparently QtConcurrent can't use move semantics, so we can't boop this to another thread.
-    // How do we make this non-blocking then?
-    m_hash = QString::number(MurmurHash2(std::move(file_stream), 4 * MiB, should_filter_out));
-
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-        emit resultsReady(m_hash);
-    }
+    setObjectName(QString("ModrinthHasher: %1").arg(file_path));
 }
 
-BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider) : Hasher(file_path), provider(provider)
+BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider)
+    : Hasher(file_path, algorithmFromName(ProviderCaps.hashType(provider).first()).value_or(Algorithm::Sha1)), provider(provider)
 {
     setObjectName(QString("BlockedModHasher: %1").arg(file_path));
-    hash_type = ProviderCaps.hashType(provider).first();
-}
-
-void BlockedModHasher::executeTask()
-{
-    QFile file(m_path);
-
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
-
-        emitFailed("Failed to open file for hashing.");
-        return;
-    }
-
-    m_hash = ProviderCaps.hash(provider, &file, hash_type);
-
-    file.close();
-
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-        emit resultsReady(m_hash);
-    }
 }
 
 QStringList BlockedModHasher::getHashTypes()
@@ -133,8 +273,9 @@ QStringList BlockedModHasher::getHashTypes()
 bool BlockedModHasher::useHashType(QString type)
 {
     auto types = ProviderCaps.hashType(provider);
-    if (types.contains(type)) {
-        hash_type = type;
+    auto algorithm = algorithmFromName(type);
+    if (types.contains(type) && algorithm) {
+        m_algorithm = *algorithm;
         return true;
     }
     qDebug() << "Bad hash type " << type << " for provider";
@@ -1,23 +1,61 @@
 #pragma once
 
+#include <QFlags>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QString>
+#include <QThreadPool>
+
+#include <optional>
 
 #include "modplatform/ModIndex.h"
 #include "tasks/Task.h"
 
 namespace Hashing {
 
+enum class Algorithm { Sha1 = 1 << 0, Sha512 = 1 << 1, Md5 = 1 << 2, Murmur2 = 1 << 3 };
+Q_DECLARE_FLAGS(Algorithms, Algorithm)
+
+/** Maps the hash type names used by the providers ("sha1", "sha512", "md5", "murmur2") to an Algorithm. */
+std::optional<Algorithm> algorithmFromName(const QString& name);
+
+/** The digests of one file, only the requested ones are set. Murmur2 is the CurseForge flavor, skipping whitespace. */
+struct Digests {
+    QString sha1;
+    QString sha512;
+    QString md5;
+    QString murmur2;
+
+    QString error;
+
+    [[nodiscard]] bool isValid() const { return error.isEmpty(); }
+    [[nodiscard]] QString get(Algorithm algorithm) const;
+};
+
+/** Computes every requested digest of the file at 'path', reading it only once. Blocks, so don't call it on the GUI thread. */
+Digests hashFile(const QString& path, Algorithms algorithms);
+
+/** Runs hashFile() on the hashing pool. */
+QFuture<Digests> hashFileAsync(const QString& path, Algorithms algorithms);
+
+/** Runs hashFile() on all of 'paths' at once, a few files at a time. The results are in the order of 'paths',
+ *  and the progress of the future counts the files that are done. */
+QFuture<Digests> hashFilesAsync(const QStringList& paths, Algorithms algorithms);
+
+/** The worker pool shared by all hashing, sized to the number of cores. */
+QThreadPool* pool();
+
 class Hasher : public Task {
     Q_OBJECT
    public:
     using Ptr = shared_qobject_ptr<Hasher>;
 
-    Hasher(QString file_path) : m_path(std::move(file_path)) {}
+    Hasher(QString file_path, Algorithm algorithm) : m_path(std::move(file_path)), m_algorithm(algorithm) {}
 
-    /* We can't really abort this task, but we can say we aborted and finish our thing quickly :) */
-    bool abort() override { return true; }
+    /* The file is still read to the end on the pool, but nobody hears about it anymore :) */
+    bool abort() override;
 
-    void executeTask() override = 0;
+    void executeTask() override;
 
     QString getResult() const { return m_hash; };
     QString getPath() const { return m_path; };
@@ -25,37 +63,37 @@ class Hasher : public Task {
    signals:
     void resultsReady(QString hash);
 
+   private slots:
+    void hashFinished();
+
    protected:
     QString m_hash;
     QString m_path;
+    Algorithm m_algorithm;
+
+   private:
+    QFutureWatcher<Digests> m_watcher;
 };
 
 class FlameHasher : public Hasher {
    public:
-    FlameHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("FlameHasher: %1").arg(file_path)); }
-
-    void executeTask() override;
+    FlameHasher(QString file_path) : Hasher(file_path, Algorithm::Murmur2) { setObjectName(QString("FlameHasher: %1").arg(file_path)); }
 };
 
 class ModrinthHasher : public Hasher {
    public:
-    ModrinthHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("ModrinthHasher: %1").arg(file_path)); }
-
-    void executeTask() override;
+    ModrinthHasher(QString file_path);
 };
 
 class BlockedModHasher : public Hasher {
    public:
     BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider);
 
-    void executeTask() override;
-
     QStringList getHashTypes();
     bool useHashType(QString type);
 
    private:
     ModPlatform::ResourceProvider provider;
-    QString hash_type;
 };
 
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider);
@@ -65,3 +103,5 @@ Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvi
 Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider, QString type);
 
 }  // namespace Hashing
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Hashing::Algorithms)
@@ -22,5 +22,7 @@ class ModrinthCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
-    NetJob::Ptr m_net_job = nullptr;
+    void parseLatestVersions(const QByteArray& response, const QHash<QString, Mod*>& mappings, const QString& best_hash_type);
+
+    Task::Ptr m_job = nullptr;
 };
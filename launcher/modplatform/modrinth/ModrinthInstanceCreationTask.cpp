@@ -231,6 +231,7 @@ bool ModrinthCreationTask::createInstance()
 
     instance.setName(name());
     instance.saveNow();
+    instanceSettings->flush();
 
     m_files_job.reset(new NetJob(tr("Mod Download Modrinth"), APPLICATION->network()));
 
@@ -18,7 +18,6 @@
 
 #include "ModrinthPackExportTask.h"
 
-#include <QCryptographicHash>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QtConcurrentRun>
@@ -27,6 +26,7 @@
 #include "minecraft/PackProfile.h"
 #include "minecraft/mod/MetadataHandler.h"
 #include "minecraft/mod/ModFolderModel.h"
+#include "modplatform/helpers/HashUtils.h"
 
 const QStringList ModrinthPackExportTask::PREFIXES({ "mods/", "coremods/", "resourcepacks/", "texturepacks/", "shaderpacks/" });
 const QStringList ModrinthPackExportTask::FILE_EXTENSIONS({ "jar", "litemod", "zip" });
@@ -47,10 +47,15 @@ ModrinthPackExportTask::ModrinthPackExportTask(const QString& name,
     , gameRoot(instance->gameRoot())
     , output(output)
     , filter(filter)
-{}
+{
+    connect(&hashWatcher, &QFutureWatcher<Hashing::Digests>::progressValueChanged, this,
+            [this](int done) { setProgress(done, filesToHash.size()); });
+    connect(&hashWatcher, &QFutureWatcher<Hashing::Digests>::finished, this, &ModrinthPackExportTask::resolveHashes);
+}
 
 void ModrinthPackExportTask::executeTask()
 {
+    instance->settings()->flush();
     setStatus(tr("Searching for files..."));
     setProgress(0, 0);
     collectFiles();
@@ -58,6 +63,12 @@ void ModrinthPackExportTask::executeTask()
 
 bool ModrinthPackExportTask::abort()
 {
+    if (hashWatcher.isRunning()) {
+        // the files being hashed right now are still read to the end, the others aren't started anymore
+        hashWatcher.cancel();
+        emitAborted();
+        return true;
+    }
     if (task) {
         task->abort();
         emitAborted();
@@ -90,9 +101,10 @@ void ModrinthPackExportTask::collectFiles()
 void ModrinthPackExportTask::collectHashes()
 {
     setStatus(tr("Finding file hashes..."));
-    for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
 
+    filesToHash.clear();
+    QStringList paths;
+    for (const QFileInfo& file : files) {
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
         // require sensible file types
         if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
@@ -102,50 +114,59 @@ void ModrinthPackExportTask::collectHashes()
             }))
             continue;
 
-        QCryptographicHash sha512(QCryptographicHash::Algorithm::Sha512);
+        filesToHash.append(file);
+        paths.append(file.absoluteFilePath());
+    }
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
-            continue;
-        }
+    // each file is read once for both hashes, on the worker threads
+    setAbortable(true);
+    setProgress(0, paths.size());
+    hashWatcher.setFuture(Hashing::hashFilesAsync(paths, Hashing::Algorithm::Sha1 | Hashing::Algorithm::Sha512));
+}
 
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
+void ModrinthPackExportTask::resolveHashes()
+{
+    if (hashWatcher.isCanceled())
+        return;
+
+    // the mods that may be resolved from their metadata, by path
+    QHash<QString, const Mod*> mods;
+    if (mcInstance) {
+        for (auto* mod : mcInstance->loaderModList()->allMods())
+            mods.insert(mod->fileinfo().absoluteFilePath(), mod);
+    }
+
+    auto results = hashWatcher.future();
+    for (int i = 0; i < filesToHash.size(); i++) {
+        const QFileInfo& file = filesToHash[i];
+        const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
+
+        const Hashing::Digests digests = results.resultAt(i);
+        if (!digests.isValid()) {
+            qWarning() << digests.error;
             continue;
         }
-        sha512.addData(data);
-
-        auto allMods = mcInstance->loaderModList()->allMods();
-        if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
-            modIter != allMods.end()) {
-            const Mod* mod = *modIter;
-            if (mod->metadata() != nullptr) {
-                QUrl& url = mod->metadata()->url;
-                // ensure the url is permitted on modrinth.com
-                if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
-                    qDebug() << "Resolving" << relative << "from index";
-
-                    QCryptographicHash sha1(QCryptographicHash::Algorithm::Sha1);
-                    sha1.addData(data);
-
-                    ResolvedFile resolvedFile{ sha1.result().toHex(), sha512.result().toHex(), url.toEncoded(), openFile.size(),
-                                               mod->metadata()->side };
-                    resolvedFiles[relative] = resolvedFile;
-
-                    // nice! we've managed to resolve based on local metadata!
-                    // no need to enqueue it
-                    continue;
-                }
+
+        if (const Mod* mod = mods.value(file.absoluteFilePath()); mod && mod->metadata() != nullptr) {
+            QUrl& url = mod->metadata()->url;
+            // ensure the url is permitted on modrinth.com
+            if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
+                qDebug() << "Resolving" << relative << "from index";
+
+                ResolvedFile resolvedFile{ digests.sha1, digests.sha512, url.toEncoded(), file.size(), mod->metadata()->side };
+                resolvedFiles[relative] = resolvedFile;
+
+                // nice! we've managed to resolve based on local metadata!
+                // no need to enqueue it
+                continue;
             }
         }
 
         qDebug() << "Enqueueing" << relative << "for Modrinth query";
-        pendingHashes[relative] = sha512.result().toHex();
+        pendingHashes[relative] = digests.sha512;
     }
 
-    setAbortable(true);
+    filesToHash.clear();
     makeApiRequest();
 }
 
@@ -23,6 +23,7 @@
 #include "BaseInstance.h"
 #include "MMCZip.h"
 #include "minecraft/MinecraftInstance.h"
+#include "modplatform/helpers/HashUtils.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "tasks/Task.h"
 
@@ -65,8 +66,13 @@ class ModrinthPackExportTask : public Task {
     QMap<QString, ResolvedFile> resolvedFiles;
     Task::Ptr task;
 
+    // the files that may be downloaded instead, in the order of the results of hashWatcher
+    QFileInfoList filesToHash;
+    QFutureWatcher<Hashing::Digests> hashWatcher;
+
     void collectFiles();
     void collectHashes();
+    void resolveHashes();
     void makeApiRequest();
     void parseApiResponse(std::shared_ptr<QByteArray> response);
     void buildZip();
@@ -118,6 +118,7 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
             }
 
             components->saveNow();
+            instanceSettings->flush();
             emit succeeded();
             return;
         }
@@ -183,5 +184,6 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
     }
 
     components->saveNow();
+    instanceSettings->flush();
     emit succeeded();
 }
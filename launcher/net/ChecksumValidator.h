@@ -51,15 +51,25 @@ class ChecksumValidator : public Validator {
     auto init(QNetworkRequest&) -> bool override
     {
         m_checksum.reset();
+        m_size = 0;
         return true;
     }
 
     auto write(QByteArray& data) -> bool override
     {
         m_checksum.addData(data);
+        m_size += data.size();
         return true;
     }
 
+    auto resume(QNetworkRequest& request, QIODevice& prefix, qint64 size) -> bool override
+    {
+        // still in the state the previous attempt left it in, no need to read it all again
+        if (size > 0 && size == m_size)
+            return true;
+        return Validator::resume(request, prefix, size);
+    }
+
     auto abort() -> bool override { return true; }
 
     auto validate(QNetworkReply&) -> bool override
@@ -78,5 +88,7 @@ class ChecksumValidator : public Validator {
    private:
     QCryptographicHash m_checksum;
     QByteArray m_expected;
+    // how much has been hashed since the last init
+    qint64 m_size = 0;
 };
 }  // namespace Net
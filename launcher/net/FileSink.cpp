@@ -35,12 +35,70 @@
 
 #include "FileSink.h"
 
+#include <QDateTime>
+#include <QDir>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+
 #include "FileSystem.h"
 
 #include "net/Logging.h"
 
 namespace Net {
 
+namespace {
+int httpStatus(QNetworkReply& reply)
+{
+    return reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+}
+
+// If-Range only works with strong validators, a weak ETag doesn't promise the bytes are the same
+QByteArray rangeValidator(QNetworkReply& reply)
+{
+    auto etag = reply.rawHeader("ETag");
+    if (!etag.isEmpty() && !etag.startsWith("W/"))
+        return etag;
+    return reply.rawHeader("Last-Modified");
+}
+
+// the first byte of "Content-Range: bytes <first>-<last>/<length>", -1 if there's no such header
+qint64 contentRangeStart(QNetworkReply& reply)
+{
+    auto range = reply.rawHeader("Content-Range").trimmed();
+    auto dash = range.indexOf('-');
+    if (!range.startsWith("bytes ") || dash < 0)
+        return -1;
+    bool ok = false;
+    auto start = range.mid(6, dash - 6).trimmed().toLongLong(&ok);
+    return ok ? start : -1;
+}
+
+// Partial files untouched for this long aren't written to by any download anymore
+constexpr qint64 stalePartialSecs = 60 * 60;
+
+// Removes the partial files of filename that earlier runs left behind, e.g. when the launcher crashed halfway through
+void removeStalePartials(const QString& filename)
+{
+    static const QRegularExpression suffix(QRegularExpression::anchoredPattern("\\.[0-9a-z]+\\.part"));
+    QFileInfo target(filename);
+    auto prefix = target.fileName();
+    auto cutoff = QDateTime::currentDateTimeUtc().addSecs(-stalePartialSecs);
+    for (auto& info : target.dir().entryInfoList({ "*.part" }, QDir::Files | QDir::Hidden)) {
+        auto name = info.fileName();
+        if (!name.startsWith(prefix) || !suffix.match(name.mid(prefix.size())).hasMatch() || info.lastModified().toUTC() >= cutoff)
+            continue;
+        qCDebug(taskNetLogC) << "Removing the leftover partial file" << info.filePath();
+        QFile::remove(info.filePath());
+    }
+}
+}  // namespace
+
+FileSink::~FileSink()
+{
+    // nobody is left to resume it
+    discardPartial();
+}
+
 Task::State FileSink::init(QNetworkRequest& request)
 {
     auto result = initCache(request);
@@ -48,30 +106,86 @@ Task::State FileSink::init(QNetworkRequest& request)
         return result;
     }
 
-    // create a new save file and open it for writing
+    // create the partial file, or reuse the one of the previous attempt
     if (!FS::ensureFilePathExists(m_filename)) {
         qCCritical(taskNetLogC) << "Could not create folder for " + m_filename;
         return Task::State::Failed;
     }
 
     wroteAnyData = false;
-    m_output_file.reset(new QSaveFile(m_filename));
-    if (!m_output_file->open(QIODevice::WriteOnly)) {
-        qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
+    m_skip_body = false;
+    m_resume_offset = 0;
+    if (!m_output_file) {
+        removeStalePartials(m_filename);
+
+        // unique, as the same file may be downloaded more than once at the same time
+        auto suffix = QString::number(QRandomGenerator::global()->generate(), 36);
+        m_output_file.reset(new QFile(QString("%1.%2.part").arg(m_filename, suffix)));
+    }
+    if (!m_output_file->isOpen() && !m_output_file->open(QIODevice::ReadWrite)) {
+        qCCritical(taskNetLogC) << "Could not open " + m_output_file->fileName() + " for writing";
+        m_output_file.reset();
         return Task::State::Failed;
     }
 
-    if (initAllValidators(request))
+    auto partial_size = m_output_file->size();
+    if (!m_resume_tag.isEmpty() && partial_size > 0) {
+        if (resumeAllValidators(request, *m_output_file, partial_size) && m_output_file->seek(partial_size)) {
+            qCDebug(taskNetLogC) << "Resuming" << m_filename << "after" << partial_size << "bytes";
+            m_resume_offset = partial_size;
+            request.setRawHeader("Range", "bytes=" + QByteArray::number(partial_size) + "-");
+            // the server sends everything again if the file changed since
+            request.setRawHeader("If-Range", m_resume_tag);
+            return Task::State::Running;
+        }
+        qCWarning(taskNetLogC) << "Could not resume" << m_filename << "starting over";
+    }
+
+    if (restart(request))
         return Task::State::Running;
     return Task::State::Failed;
 }
 
+Task::State FileSink::begin(QNetworkReply& reply)
+{
+    auto status = httpStatus(reply);
+    if (status >= 300) {
+        // a redirect is followed with another attempt, and an error fails this one. Either way, the partial file stays as it is,
+        // unless the server says there's nothing left to resume
+        if (status == 416)
+            m_resume_tag.clear();
+        m_skip_body = true;
+        return Task::State::Running;
+    }
+
+    if (m_resume_offset > 0) {
+        if (status == 206) {
+            if (contentRangeStart(reply) == m_resume_offset)
+                return Task::State::Running;
+            qCCritical(taskNetLogC) << "Got the wrong part of" << m_filename << ":" << reply.rawHeader("Content-Range");
+            discardPartial();
+            return Task::State::Failed;
+        }
+
+        // the file changed, or the server can't send parts of it
+        qCDebug(taskNetLogC) << "Could not resume" << m_filename << "downloading all of it again";
+        auto request = reply.request();
+        if (!restart(request))
+            return Task::State::Failed;
+    }
+
+    m_resume_tag = rangeValidator(reply);
+    return Task::State::Running;
+}
+
 Task::State FileSink::write(QByteArray& data)
 {
+    if (m_skip_body)
+        return Task::State::Running;
+
     if (!writeAllValidators(data) || m_output_file->write(data) != data.size()) {
         qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
-        m_output_file->cancelWriting();
-        m_output_file.reset();
+        discardPartial();
         wroteAnyData = false;
         return Task::State::Failed;
     }
@@ -82,8 +196,16 @@ Task::State FileSink::write(QByteArray& data)
 
 Task::State FileSink::abort()
 {
-    m_output_file->cancelWriting();
     failAllValidators();
+    if (m_output_file) {
+        // keep what we got for the next attempt, if the server can tell whether it's still good by then
+        if (m_resume_tag.isEmpty() || !m_output_file->flush() || m_output_file->size() == 0) {
+            discardPartial();
+        } else {
+            qCDebug(taskNetLogC) << "Keeping" << m_output_file->size() << "bytes of" << m_filename << "to resume later";
+            m_output_file->close();
+        }
+    }
     return Task::State::Failed;
 }
 
@@ -95,31 +217,57 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     int statusCode = statusCodeV.toInt(&validStatus);
     if (validStatus) {
         // this leaves out 304 Not Modified
-        gotFile = statusCode == 200 || statusCode == 203;
+        gotFile = statusCode == 200 || statusCode == 203 || (statusCode == 206 && m_resume_offset > 0);
     }
 
-    // if we wrote any data to the save file, we try to commit the data to the real file.
+    // if we wrote any data to the partial file, we try to commit the data to the real file.
     // if it actually got a proper file, we write it even if it was empty
     if (gotFile || wroteAnyData) {
         // ask validators for data consistency
         // we only do this for actual downloads, not 'your data is still the same' cache hits
-        if (!finalizeAllValidators(reply))
+        if (!finalizeAllValidators(reply)) {
+            // no use in resuming a broken file
+            discardPartial();
             return Task::State::Failed;
+        }
 
         // nothing went wrong...
-        if (!m_output_file->commit()) {
+        bool flushed = m_output_file->flush();
+        m_output_file->close();
+        if (!flushed || !FS::move(m_output_file->fileName(), m_filename)) {
             qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename;
-            m_output_file->cancelWriting();
+            discardPartial();
             return Task::State::Failed;
         }
+        m_output_file.reset();
     }
 
-    // then get rid of the save file
-    m_output_file.reset();
+    // then get rid of the partial file, if it's still there
+    discardPartial();
 
     return finalizeCache(reply);
 }
 
+auto FileSink::restart(QNetworkRequest& request) -> bool
+{
+    m_resume_offset = 0;
+    m_resume_tag.clear();
+    if (!m_output_file->resize(0) || !m_output_file->seek(0)) {
+        qCCritical(taskNetLogC) << "Could not empty" << m_output_file->fileName();
+        return false;
+    }
+    return initAllValidators(request);
+}
+
+void FileSink::discardPartial()
+{
+    m_resume_tag.clear();
+    if (m_output_file) {
+        m_output_file->remove();
+        m_output_file.reset();
+    }
+}
+
 Task::State FileSink::initCache(QNetworkRequest&)
 {
     return Task::State::Running;
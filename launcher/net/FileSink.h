@@ -35,18 +35,22 @@
 
 #pragma once
 
-#include <QSaveFile>
+#include <QFile>
 
 #include "Sink.h"
 
 namespace Net {
+/* Downloads into a partial file next to the target, which replaces the target once it's complete.
+ * When a download fails halfway, the partial file is kept around, and the next attempt only asks for what's missing
+ * if the server still has the same version of the file. */
 class FileSink : public Sink {
    public:
     FileSink(QString filename) : m_filename(filename){};
-    virtual ~FileSink() = default;
+    virtual ~FileSink();
 
    public:
     auto init(QNetworkRequest& request) -> Task::State override;
+    auto begin(QNetworkReply& reply) -> Task::State override;
     auto write(QByteArray& data) -> Task::State override;
     auto abort() -> Task::State override;
     auto finalize(QNetworkReply& reply) -> Task::State override;
@@ -57,9 +61,21 @@ class FileSink : public Sink {
     virtual auto initCache(QNetworkRequest&) -> Task::State;
     virtual auto finalizeCache(QNetworkReply& reply) -> Task::State;
 
+   private:
+    // empties the partial file to download everything again
+    auto restart(QNetworkRequest& request) -> bool;
+    void discardPartial();
+
    protected:
     QString m_filename;
     bool wroteAnyData = false;
-    std::unique_ptr<QSaveFile> m_output_file;
+    std::unique_ptr<QFile> m_output_file;
+
+    // what the partial file held when the current attempt started
+    qint64 m_resume_offset = 0;
+    // the ETag or Last-Modified date of the version in the partial file, empty if it can't be resumed
+    QByteArray m_resume_tag;
+    // the reply is a redirect or an error, what it says isn't the file
+    bool m_skip_body = false;
 };
 }  // namespace Net
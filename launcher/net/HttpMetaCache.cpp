@@ -39,21 +39,75 @@
 
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 
 #include <QDebug>
 
 #include "net/Logging.h"
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace {
+constexpr quint32 indexMagic = 0x504d4349;  // "PMCI"
+constexpr quint32 indexVersion = 1;
+constexpr auto streamVersion = QDataStream::Qt_5_12;
+
+enum RecordType : quint8 { PutRecord = 1, RemoveRecord = 2 };
+
+// the journal is folded into the snapshot once it holds more records than this, or than half the entries
+constexpr int minCompactionRecords = 256;
+
+void writeHeader(QDataStream& out)
+{
+    out << indexMagic << indexVersion;
+}
+
+bool readHeader(QDataStream& in)
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    return in.status() == QDataStream::Ok && magic == indexMagic && version == indexVersion;
+}
+
+// The inode tells apart a file replaced by another one with the same size and modification time.
+// Where there's no such thing, size and modification time have to do.
+quint64 fileInode(const QString& path)
+{
+#ifdef Q_OS_UNIX
+    struct stat buf;
+    if (::stat(QFile::encodeName(path).constData(), &buf) == 0)
+        return static_cast<quint64>(buf.st_ino);
+#else
+    Q_UNUSED(path);
+#endif
+    return 0;
+}
+}  // namespace
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
     return FS::PathCombine(m_basePath, m_relativePath);
 }
 
+void MetaEntry::setLocalFile(const QFileInfo& file)
+{
+    m_local_changed_timestamp = file.lastModified().toUTC().toMSecsSinceEpoch();
+    m_local_size = file.size();
+    m_local_inode = fileInode(file.absoluteFilePath());
+}
+
 HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
 {
+    if (!m_index_file.isNull())
+        m_index_dir = m_index_file + ".d";
+
     saveBatchingTimer.setSingleShot(true);
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
 
@@ -69,17 +123,13 @@ HttpMetaCache::~HttpMetaCache()
 auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
     // no base. no base path. can't store
-    if (!m_entries.contains(base)) {
+    auto map = baseEntries(base);
+    if (!map) {
         // TODO: log problem
         return {};
     }
 
-    EntryMap& map = m_entries[base];
-    if (map.entry_list.contains(resource_path)) {
-        return map.entry_list[resource_path];
-    }
-
-    return {};
+    return map->entry_list.value(resource_path);
 }
 
 auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
@@ -90,36 +140,54 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
         return staleEntry(base, resource_path);
     }
 
-    auto& selected_base = m_entries[base];
+    auto& selected_base = *baseEntries(base);
     QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
     QFileInfo finfo(real_path);
 
     // is the file really there? if not -> stale
     if (!finfo.isFile() || !finfo.isReadable()) {
         // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(selected_base, resource_path);
         return staleEntry(base, resource_path);
     }
 
     if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
         // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(selected_base, resource_path);
         return staleEntry(base, resource_path);
     }
 
-    // if the file changed, check md5sum
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
-    if (file_last_changed != entry->m_local_changed_timestamp) {
+    qint64 file_size = finfo.size();
+    quint64 file_inode = fileInode(real_path);
+
+    // entries carried over from the old JSON index only have the modification time to go by
+    bool known_size = entry->m_local_size >= 0;
+    bool unchanged = file_last_changed == entry->m_local_changed_timestamp &&
+                     (!known_size || (file_size == entry->m_local_size && file_inode == entry->m_local_inode));
+
+    if (!unchanged) {
+        // a file of another size can't have the same contents, no need to read it
+        if (known_size && file_size != entry->m_local_size) {
+            removeEntry(selected_base, resource_path);
+            return staleEntry(base, resource_path);
+        }
+
+        // the file may have changed, check md5sum
         QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
-        if (entry->m_md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        if (!input.open(QIODevice::ReadOnly) || !md5.addData(&input) || entry->m_md5sum != QString::fromLatin1(md5.result().toHex())) {
+            removeEntry(selected_base, resource_path);
             return staleEntry(base, resource_path);
         }
+    }
 
+    if (!unchanged || !known_size) {
         // md5sums matched... keep entry and save the new state to file
         entry->m_local_changed_timestamp = file_last_changed;
+        entry->m_local_size = file_size;
+        entry->m_local_inode = file_inode;
+        selected_base.dirty.insert(resource_path);
         SaveEventually();
     }
 
@@ -128,7 +196,7 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
     if (entry->isExpired(current_time - (file_last_changed / 1000))) {
         qCWarning(taskNetLogC) << "[HttpMetaCache]"
                                << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
+        removeEntry(selected_base, resource_path);
         return staleEntry(base, resource_path);
     }
 
@@ -139,7 +207,8 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
 
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
-    if (!m_entries.contains(stale_entry->m_baseId)) {
+    auto map = baseEntries(stale_entry->m_baseId);
+    if (!map) {
         qCCritical(taskHttpMetaCacheLogC) << "Cannot add entry with unknown base: " << stale_entry->m_baseId.toLocal8Bit();
         return false;
     }
@@ -149,7 +218,8 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
         return false;
     }
 
-    m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
+    map->entry_list[stale_entry->m_relativePath] = stale_entry;
+    map->dirty.insert(stale_entry->m_relativePath);
     SaveEventually();
 
     return true;
@@ -161,15 +231,17 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->m_stale = true;
+    if (auto map = baseEntries(entry->m_baseId))
+        map->dirty.insert(entry->m_relativePath);
     SaveEventually();
     return true;
 }
 
 void HttpMetaCache::evictAll()
 {
-    for (QString& base : m_entries.keys()) {
-        EntryMap& map = m_entries[base];
-        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        EntryMap& map = *baseEntries(it.key());
+        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << it.key();
         for (MetaEntryPtr entry : map.entry_list) {
             if (!evictEntry(entry))
                 qCWarning(taskHttpMetaCacheLogC) << "Unexpected missing cache entry" << entry->m_basePath;
@@ -197,23 +269,56 @@ void HttpMetaCache::addBase(QString base, QString base_root)
     // TODO: check if the base path is valid
     EntryMap foo;
     foo.base_path = base_root;
+    // nothing to load without an index
+    foo.loaded = m_index_file.isNull();
     m_entries[base] = foo;
 }
 
 auto HttpMetaCache::getBasePath(QString base) -> QString
 {
-    if (m_entries.contains(base)) {
-        return m_entries[base].base_path;
+    auto it = m_entries.constFind(base);
+    if (it != m_entries.constEnd()) {
+        return it->base_path;
     }
 
     return {};
 }
 
+auto HttpMetaCache::baseEntries(const QString& base) -> EntryMap*
+{
+    auto it = m_entries.find(base);
+    if (it == m_entries.end())
+        return nullptr;
+
+    if (!it->loaded)
+        loadBase(base, *it);
+    return &*it;
+}
+
+void HttpMetaCache::removeEntry(EntryMap& map, const QString& resource_path)
+{
+    map.entry_list.remove(resource_path);
+    map.dirty.insert(resource_path);
+    SaveEventually();
+}
+
+auto HttpMetaCache::indexPath(const QString& base, const QString& suffix) const -> QString
+{
+    return FS::PathCombine(m_index_dir, base + suffix);
+}
+
 void HttpMetaCache::Load()
 {
     if (m_index_file.isNull())
         return;
 
+    // the per-base index takes over from the old JSON one, which is left alone for older versions
+    if (!QFileInfo::exists(m_index_dir) && QFileInfo::exists(m_index_file))
+        loadLegacyIndex();
+}
+
+void HttpMetaCache::loadLegacyIndex()
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
         return;
@@ -242,6 +347,9 @@ void HttpMetaCache::Load()
     if (version_val != "1")
         return;
 
+    for (auto& map : m_entries)
+        map.loaded = true;
+
     // read the entry array
     auto array = Json::ensureArray(root, "entries");
     for (auto element : array) {
@@ -271,6 +379,88 @@ void HttpMetaCache::Load()
 
         entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
     }
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        compactBase(it.key(), *it);
+}
+
+void HttpMetaCache::loadBase(const QString& base, EntryMap& map)
+{
+    map.loaded = true;
+
+    bool intact = true;
+    int records = 0;
+
+    QFile snapshot(indexPath(base, ".index"));
+    if (snapshot.open(QIODevice::ReadOnly))
+        intact &= readRecords(snapshot, base, map, records);
+
+    QFile journal(indexPath(base, ".journal"));
+    if (journal.open(QIODevice::ReadOnly)) {
+        records = 0;
+        intact &= readRecords(journal, base, map, records);
+        map.journal_records = records;
+    }
+
+    // anything appended after a damaged record would never be read back, so start over from what we have
+    if (!intact)
+        compactBase(base, map);
+}
+
+auto HttpMetaCache::readRecords(QIODevice& device, const QString& base, EntryMap& map, int& records) -> bool
+{
+    QDataStream in(&device);
+    in.setVersion(streamVersion);
+    if (!readHeader(in)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Ignoring unknown cache index of" << base;
+        return false;
+    }
+
+    while (!in.atEnd()) {
+        quint8 type;
+        QString path;
+        in >> type >> path;
+
+        if (type == PutRecord) {
+            auto foo = new MetaEntry();
+            foo->m_baseId = base;
+            foo->m_relativePath = path;
+            in >> foo->m_md5sum >> foo->m_etag >> foo->m_local_changed_timestamp >> foo->m_remote_changed_timestamp >> foo->m_is_eternal >>
+                foo->m_current_age >> foo->m_max_age >> foo->m_local_size >> foo->m_local_inode;
+            // presumed innocent until closer examination
+            foo->m_stale = false;
+
+            if (in.status() != QDataStream::Ok) {
+                delete foo;
+                break;
+            }
+            map.entry_list[path] = MetaEntryPtr(foo);
+        } else if (type == RemoveRecord && in.status() == QDataStream::Ok) {
+            map.entry_list.remove(path);
+        } else {
+            break;
+        }
+        records++;
+    }
+
+    // a record cut short by a crash just means that change is lost
+    if (in.status() != QDataStream::Ok || !in.atEnd()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Cache index of" << base << "is truncated after" << records << "records";
+        return false;
+    }
+    return true;
+}
+
+void HttpMetaCache::writePut(QDataStream& out, const MetaEntry& entry)
+{
+    out << quint8(PutRecord) << entry.m_relativePath << entry.m_md5sum << entry.m_etag << entry.m_local_changed_timestamp
+        << entry.m_remote_changed_timestamp << entry.m_is_eternal << entry.m_current_age << entry.m_max_age << entry.m_local_size
+        << entry.m_local_inode;
+}
+
+void HttpMetaCache::writeRemove(QDataStream& out, const QString& resource_path)
+{
+    out << quint8(RemoveRecord) << resource_path;
 }
 
 void HttpMetaCache::SaveEventually()
@@ -285,41 +475,85 @@ void HttpMetaCache::SaveNow()
     if (m_index_file.isNull())
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->loaded && !it->dirty.isEmpty())
+            saveBase(it.key(), *it);
+    }
+}
 
-    QJsonObject toplevel;
-    Json::writeString(toplevel, "version", "1");
+void HttpMetaCache::saveBase(const QString& base, EntryMap& map)
+{
+    qCDebug(taskHttpMetaCacheLogC) << "Saving" << map.dirty.size() << "changed metacache entries of" << base;
 
-    QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
-            // do not save stale entries. they are dead.
-            if (entry->m_stale) {
-                continue;
-            }
+    const int dirty = static_cast<int>(map.dirty.size());
+    if (map.journal_records + dirty > qMax(minCompactionRecords, static_cast<int>(map.entry_list.size() / 2))) {
+        compactBase(base, map);
+        return;
+    }
 
-            QJsonObject entryObj;
-            Json::writeString(entryObj, "base", entry->m_baseId);
-            Json::writeString(entryObj, "path", entry->m_relativePath);
-            Json::writeString(entryObj, "md5sum", entry->m_md5sum);
-            Json::writeString(entryObj, "etag", entry->m_etag);
-            entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->m_local_changed_timestamp)));
-            if (!entry->m_remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp", QJsonValue(entry->m_remote_changed_timestamp));
-            if (entry->isEternal()) {
-                entryObj.insert("eternal", true);
-            } else {
-                entryObj.insert("current_age", QJsonValue(double(entry->m_current_age)));
-                entryObj.insert("max_age", QJsonValue(double(entry->m_max_age)));
-            }
-            entriesArr.append(entryObj);
-        }
+    if (!FS::ensureFolderPathExists(m_index_dir)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache: could not create" << m_index_dir;
+        return;
+    }
+
+    QFile journal(indexPath(base, ".journal"));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << journal.errorString();
+        return;
+    }
+
+    QDataStream out(&journal);
+    out.setVersion(streamVersion);
+    if (journal.size() == 0)
+        writeHeader(out);
+
+    for (auto& path : map.dirty) {
+        auto entry = map.entry_list.value(path);
+        // do not save stale entries. they are dead.
+        if (entry && !entry->m_stale)
+            writePut(out, *entry);
+        else
+            writeRemove(out, path);
+    }
+
+    if (out.status() != QDataStream::Ok || !journal.flush()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << journal.errorString();
+        return;
+    }
+
+    map.journal_records += dirty;
+    map.dirty.clear();
+}
+
+void HttpMetaCache::compactBase(const QString& base, EntryMap& map)
+{
+    if (!FS::ensureFolderPathExists(m_index_dir)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache: could not create" << m_index_dir;
+        return;
+    }
+
+    QSaveFile snapshot(indexPath(base, ".index"));
+    if (!snapshot.open(QIODevice::WriteOnly)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << snapshot.errorString();
+        return;
+    }
+
+    QDataStream out(&snapshot);
+    out.setVersion(streamVersion);
+    writeHeader(out);
+    for (auto& entry : map.entry_list) {
+        // do not save stale entries. they are dead.
+        if (!entry->m_stale)
+            writePut(out, *entry);
     }
-    toplevel.insert("entries", entriesArr);
 
-    try {
-        Json::write(toplevel, m_index_file);
-    } catch (const Exception& e) {
-        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
+    if (out.status() != QDataStream::Ok || !snapshot.commit()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << snapshot.errorString();
+        return;
     }
+
+    // replaying the old journal over the new snapshot would be harmless, so a crash right here loses nothing
+    QFile::remove(indexPath(base, ".journal"));
+    map.journal_records = 0;
+    map.dirty.clear();
 }
@@ -35,7 +35,10 @@
 
 #pragma once
 
-#include <QMap>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QTimer>
 #include <memory>
@@ -57,6 +60,8 @@ class MetaEntry {
     auto getRemoteChangedTimestamp() -> QString { return m_remote_changed_timestamp; }
     void setRemoteChangedTimestamp(QString remote_changed_timestamp) { m_remote_changed_timestamp = remote_changed_timestamp; }
     void setLocalChangedTimestamp(qint64 timestamp) { m_local_changed_timestamp = timestamp; }
+    /* Remembers the modification time, size and inode of the file as it is now, after its md5sum was computed. */
+    void setLocalFile(const QFileInfo& file);
 
     auto getETag() -> QString { return m_etag; }
     void setETag(QString etag) { m_etag = etag; }
@@ -84,6 +89,8 @@ class MetaEntry {
     QString m_etag;
 
     qint64 m_local_changed_timestamp = 0;
+    qint64 m_local_size = -1;  // -1 when unknown
+    quint64 m_local_inode = 0;
     QString m_remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 m_current_age = 0;
     qint64 m_max_age = 0;
@@ -94,6 +101,12 @@ class MetaEntry {
 
 using MetaEntryPtr = std::shared_ptr<MetaEntry>;
 
+/** Remembers what was downloaded where, so unchanged files don't have to be downloaded again.
+ *
+ *  Each base is indexed in its own snapshot file plus an append-only journal, both in a directory next to the index path.
+ *  A base is only read the first time it's used, saving appends the entries that changed since the last save to the
+ *  journal, and the journal is folded back into the snapshot once it grows too long.
+ */
 class HttpMetaCache : public QObject {
     Q_OBJECT
    public:
@@ -119,6 +132,7 @@ class HttpMetaCache : public QObject {
 
     // (re)start a timer that calls SaveNow later.
     void SaveEventually();
+    // moves a legacy JSON index over, the bases themselves are loaded when they're first used
     void Load();
 
     auto getBasePath(QString base) -> QString;
@@ -132,10 +146,32 @@ class HttpMetaCache : public QObject {
 
     struct EntryMap {
         QString base_path;
-        QMap<QString, MetaEntryPtr> entry_list;
+        QHash<QString, MetaEntryPtr> entry_list;
+
+        bool loaded = false;
+        // entries whose current state still has to be appended to the journal
+        QSet<QString> dirty;
+        // records in the journal since the last compaction
+        int journal_records = 0;
     };
 
-    QMap<QString, EntryMap> m_entries;
+    // the entries of 'base', loading them if needed. nullptr if the base is unknown
+    auto baseEntries(const QString& base) -> EntryMap*;
+    void removeEntry(EntryMap& map, const QString& resource_path);
+
+    void loadLegacyIndex();
+    void loadBase(const QString& base, EntryMap& map);
+    void saveBase(const QString& base, EntryMap& map);
+    void compactBase(const QString& base, EntryMap& map);
+    // applies the records of an index file to 'map', returns false if the file is damaged
+    auto readRecords(QIODevice& device, const QString& base, EntryMap& map, int& records) -> bool;
+    auto indexPath(const QString& base, const QString& suffix) const -> QString;
+
+    static void writePut(QDataStream& out, const MetaEntry& entry);
+    static void writeRemove(QDataStream& out, const QString& resource_path);
+
+    QHash<QString, EntryMap> m_entries;
     QString m_index_file;
+    QString m_index_dir;
     QTimer saveBatchingTimer;
 };
@@ -57,6 +57,7 @@ class NetAction : public Task {
     QUrl url() { return m_url; }
 
     void setNetwork(shared_qobject_ptr<QNetworkAccessManager> network) { m_network = network; }
+    void setHttp2Allowed(bool allowed) { m_allow_http2 = allowed; }
 
     void addHeaderProxy(Net::HeaderProxy* proxy) { m_headerProxies.push_back(std::shared_ptr<Net::HeaderProxy>(proxy)); }
     virtual void init() = 0;
@@ -96,5 +97,7 @@ class NetAction : public Task {
 
     /// source URL
     QUrl m_url;
+    /// whether the request may be made over HTTP/2, when the server supports it
+    bool m_allow_http2 = false;
     std::vector<std::shared_ptr<Net::HeaderProxy>> m_headerProxies;
 };
@@ -36,6 +36,7 @@
  */
 
 #include "NetJob.h"
+#include "net/Logging.h"
 #include "tasks/ConcurrentTask.h"
 #if defined(LAUNCHER_APPLICATION)
 #include "Application.h"
@@ -44,8 +45,24 @@
 NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network) : ConcurrentTask(nullptr, job_name), m_network(network)
 {
 #if defined(LAUNCHER_APPLICATION)
-    setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt());
+    // the tests run without the application
+    if (auto app = qobject_cast<Application*>(QCoreApplication::instance())) {
+        setMaxConcurrent(app->settings()->get("NumberOfConcurrentDownloads").toInt());
+        setHttp2Allowed(app->settings()->get("UseHttp2").toBool());
+    }
 #endif
+
+    connect(this, &Task::finished, this, [this] {
+        if (!m_timer.isValid())
+            return;
+        m_metrics.elapsedMs = m_timer.elapsed();
+        m_timer.invalidate();
+
+        auto metrics = this->metrics();
+        qCDebug(taskNetLogC) << objectName() << "made" << metrics.requests << "requests," << metrics.failed << "failed, received"
+                             << metrics.bytesReceived << "bytes in" << metrics.elapsedMs << "ms:" << qRound64(metrics.bytesPerSecond())
+                             << "bytes/s, at most" << metrics.peakPerHost << "requests per host";
+    });
 }
 
 auto NetJob::addNetAction(NetAction::Ptr action) -> bool
@@ -57,6 +74,24 @@ auto NetJob::addNetAction(NetAction::Ptr action) -> bool
     return true;
 }
 
+auto NetJob::metrics() const -> Metrics
+{
+    auto metrics = m_metrics;
+    if (m_timer.isValid())
+        metrics.elapsedMs = m_timer.elapsed();
+    metrics.failed = m_failed.size();
+    return metrics;
+}
+
+void NetJob::executeTask()
+{
+    m_metrics = {};
+    m_hosts.clear();
+    m_received.clear();
+    m_timer.start();
+    ConcurrentTask::executeTask();
+}
+
 void NetJob::executeNextSubTask()
 {
     // We're finished, check for failures and retry if we can (up to 3 times)
@@ -65,7 +100,93 @@ void NetJob::executeNextSubTask()
         while (!m_failed.isEmpty())
             m_queue.enqueue(m_failed.take(*m_failed.keyBegin()));
     }
-    ConcurrentTask::executeNextSubTask();
+
+    if (!isRunning() || m_queue.isEmpty()) {
+        ConcurrentTask::executeNextSubTask();
+        return;
+    }
+
+    // Whatever can't start now waits for its host to be less busy, and gets started as its downloads finish
+    while (m_doing.count() < m_total_max_size) {
+        auto next = takeNextAction();
+        if (!next)
+            break;
+        startAction(next);
+    }
+}
+
+auto NetJob::maxPerHost() const -> int
+{
+    if (m_max_per_host > 0)
+        return m_max_per_host;
+    // HTTP/2 multiplexes all requests over a single connection, while Qt never opens more than 6 HTTP/1.1 connections to a host.
+    // Any more requests would just wait inside of Qt, where they can't be interleaved anymore.
+    return m_allow_http2 ? qMax(1, m_total_max_size) : 6;
+}
+
+auto NetJob::hostOf(Task* task) -> QString
+{
+    // following redirects doesn't move a request to another host, as far as scheduling is concerned
+    auto host = m_hosts.find(task);
+    if (host == m_hosts.end())
+        host = m_hosts.insert(task, static_cast<NetAction*>(task)->url().host());
+    return *host;
+}
+
+static bool isLarge(Task* task)
+{
+    // what the action was told to expect, or what the server announced the last time it was tried
+    return task->getTotalProgress() >= NetJob::largeDownloadSize;
+}
+
+auto NetJob::takeNextAction() -> Task::Ptr
+{
+    QHash<QString, int> running;
+    int large = 0;
+    for (auto& task : m_doing) {
+        running[hostOf(task.get())]++;
+        large += isLarge(task.get());
+    }
+
+    const int perHost = maxPerHost();
+    auto hasRoom = [&](Task* task) { return running.value(hostOf(task)) < perHost; };
+
+    // The large downloads are what the job ends up waiting on, so they go first, but they only get half of the slots to
+    // keep the small ones coming in between
+    const bool wantLarge = large < qMax(1, m_total_max_size / 2);
+    int next = -1;
+    int fallback = -1;
+    for (int i = 0; i < m_queue.size() && next == -1; i++) {
+        auto task = m_queue.at(i).get();
+        if (isLarge(task) == wantLarge) {
+            if (hasRoom(task))
+                next = i;
+        } else if (fallback == -1 && hasRoom(task)) {
+            fallback = i;
+        }
+    }
+    if (next == -1)
+        next = fallback;
+    if (next == -1)
+        return nullptr;
+
+    auto task = m_queue.takeAt(next);
+    m_metrics.peakPerHost = qMax(m_metrics.peakPerHost, running.value(hostOf(task.get())) + 1);
+    return task;
+}
+
+void NetJob::startAction(Task::Ptr action)
+{
+    static_cast<NetAction*>(action.get())->setHttp2Allowed(m_allow_http2);
+    m_metrics.requests++;
+
+    // the received bytes start over when a request is retried or redirected
+    connect(action.get(), &Task::progress, this, [this, task = action.get()](qint64 current, qint64) {
+        auto& received = m_received[task];
+        m_metrics.bytesReceived += current >= received ? current - received : current;
+        received = current;
+    });
+    startSubTask(action);
 }
 
 auto NetJob::size() const -> int
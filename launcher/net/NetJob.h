@@ -38,6 +38,7 @@
 
 #include <QtNetwork>
 
+#include <QElapsedTimer>
 #include <QObject>
 #include "NetAction.h"
 #include "tasks/ConcurrentTask.h"
@@ -52,9 +53,31 @@ class NetJob : public ConcurrentTask {
    public:
     using Ptr = shared_qobject_ptr<NetJob>;
 
+    // Downloads expected to be at least this big are scheduled as large ones
+    static constexpr qint64 largeDownloadSize = 1024 * 1024;
+
+    struct Metrics {
+        // started requests, retries included
+        int requests = 0;
+        int failed = 0;
+        qint64 bytesReceived = 0;
+        qint64 elapsedMs = 0;
+        // the most requests that were running at once against a single host
+        int peakPerHost = 0;
+
+        auto bytesPerSecond() const -> double { return elapsedMs > 0 ? bytesReceived * 1000.0 / elapsedMs : 0; }
+    };
+
     explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network);
     ~NetJob() override = default;
 
+    // safe to call before starting the task, 0 picks a limit fitting the protocol
+    void setMaxConcurrentPerHost(int max_concurrent) { m_max_per_host = max_concurrent; }
+    // safe to call before starting the task
+    void setHttp2Allowed(bool allowed) { m_allow_http2 = allowed; }
+
+    auto metrics() const -> Metrics;
+
     auto size() const -> int;
 
     auto canAbort() const -> bool override;
@@ -68,13 +91,27 @@ class NetJob : public ConcurrentTask {
     bool abort() override;
 
    protected slots:
+    void executeTask() override;
     void executeNextSubTask() override;
 
    protected:
     void updateState() override;
 
    private:
+    auto maxPerHost() const -> int;
+    auto hostOf(Task* task) -> QString;
+    auto takeNextAction() -> Task::Ptr;
+    void startAction(Task::Ptr action);
+
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
     int m_try = 1;
+
+    int m_max_per_host = 0;
+    bool m_allow_http2 = false;
+    QHash<Task*, QString> m_hosts;
+
+    Metrics m_metrics;
+    QElapsedTimer m_timer;
+    QHash<Task*, qint64> m_received;
 };
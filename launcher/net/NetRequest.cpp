@@ -93,7 +93,9 @@ void NetRequest::executeTask()
     }
 
 #if defined(LAUNCHER_APPLICATION)
-    auto user_agent = APPLICATION->getUserAgent();
+    // the tests run without the application
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    auto user_agent = app ? app->getUserAgent() : BuildConfig.USER_AGENT;
 #else
     auto user_agent = BuildConfig.USER_AGENT;
 #endif
@@ -108,8 +110,16 @@ void NetRequest::executeTask()
     request.setTransferTimeout();
 #endif
 
+    // set either way, Qt 6 allows HTTP/2 unless told otherwise
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, m_allow_http2);
+#else
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, m_allow_http2);
+#endif
+
     m_last_progress_time = m_clock.now();
     m_last_progress_bytes = 0;
+    m_sink_began = false;
 
     QNetworkReply* rep = getReply(request);
     if (rep == nullptr)  // it failed
@@ -272,6 +282,14 @@ void NetRequest::downloadFinished()
         return;
     }
 
+    if (!beginSink()) {
+        m_sink->abort();
+        m_reply.reset();
+        emit failed("");
+        emit finished();
+        return;
+    }
+
     // make sure we got all the remaining data, if any
     auto data = m_reply->readAll();
     if (data.size()) {
@@ -306,6 +324,8 @@ void NetRequest::downloadFinished()
 void NetRequest::downloadReadyRead()
 {
     if (m_state == State::Running) {
+        if (!beginSink())
+            return;
         auto data = m_reply->readAll();
         m_state = m_sink->write(data);
         if (m_state == State::Failed) {
@@ -317,6 +337,20 @@ void NetRequest::downloadReadyRead()
     }
 }
 
+auto NetRequest::beginSink() -> bool
+{
+    if (m_sink_began)
+        return true;
+    m_sink_began = true;
+
+    m_state = m_sink->begin(*m_reply);
+    if (m_state != State::Running) {
+        qCCritical(logCat) << getUid().toString() << "Sink refused the response to" << m_url.toString();
+        return false;
+    }
+    return true;
+}
+
 auto NetRequest::abort() -> bool
 {
     m_state = State::AbortedByUser;
@@ -71,6 +71,8 @@ class NetRequest : public NetAction {
 
    private:
     auto handleRedirect() -> bool;
+    // lets the sink know about the reply before its data comes in
+    auto beginSink() -> bool;
     virtual QNetworkReply* getReply(QNetworkRequest&) = 0;
 
    protected slots:
@@ -93,6 +95,8 @@ class NetRequest : public NetAction {
     std::chrono::steady_clock m_clock;
     std::chrono::time_point<std::chrono::steady_clock> m_last_progress_time;
     qint64 m_last_progress_bytes;
+
+    bool m_sink_began = false;
 };
 }  // namespace Net
 
@@ -51,6 +51,9 @@ class Sink {
     virtual auto abort() -> Task::State = 0;
     virtual auto finalize(QNetworkReply& reply) -> Task::State = 0;
 
+    /* Called once the headers of a reply came in, before any of its data is written */
+    virtual auto begin(QNetworkReply&) -> Task::State { return Task::State::Running; }
+
     virtual auto hasLocalData() -> bool = 0;
 
     void addValidator(Validator* validator)
@@ -69,6 +72,14 @@ class Sink {
         }
         return true;
     }
+    bool resumeAllValidators(QNetworkRequest& request, QIODevice& prefix, qint64 size)
+    {
+        for (auto& validator : validators) {
+            if (!prefix.seek(0) || !validator->resume(request, prefix, size))
+                return false;
+        }
+        return true;
+    }
     bool finalizeAllValidators(QNetworkReply& reply)
     {
         for (auto& validator : validators) {
@@ -47,5 +47,20 @@ class Validator {
     virtual bool write(QByteArray& data) = 0;
     virtual bool abort() = 0;
     virtual bool validate(QNetworkReply& reply) = 0;
+
+    /* Starts over for a download that continues after the first 'size' bytes of 'prefix', which were already downloaded.
+     * By default, the prefix is fed through as if it just came in. */
+    virtual bool resume(QNetworkRequest& request, QIODevice& prefix, qint64 size)
+    {
+        if (!init(request))
+            return false;
+        while (size > 0) {
+            auto chunk = prefix.read(qMin<qint64>(size, 1024 * 1024));
+            if (chunk.isEmpty() || !write(chunk))
+                return false;
+            size -= chunk.size();
+        }
+        return true;
+    }
 };
 }  // namespace Net
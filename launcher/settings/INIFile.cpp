@@ -37,31 +37,584 @@
 #include "settings/INIFile.h"
 #include <FileSystem.h>
 
+#include <QBuffer>
 #include <QDebug>
 #include <QFile>
-#include <QSaveFile>
 #include <QStringList>
 #include <QTemporaryFile>
 #include <QTextStream>
 
 #include <QSettings>
 
-INIFile::INIFile() {}
+#include <optional>
 
-bool INIFile::saveFile(QString fileName)
+namespace {
+// QSettings::IniFormat, read and written directly rather than through QSettings, which only works on files and parses,
+// sorts and syncs a lot more than a flat config needs. The rules are QSettings' own, so the files can still be read by it, and by
+// older versions of the launcher. Values only QSettings knows how to decode (@Variant, @Rect...) are left to it.
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+// Qt 6 reads and writes the files as UTF-8
+constexpr bool s_utf8 = true;
+#else
+// Qt 5 reads them as Latin-1 unless they start with a BOM, and escapes everything outside of ASCII when writing
+constexpr bool s_utf8 = false;
+#endif
+
+#if defined(Q_OS_WIN)
+const char s_eol[] = "\r\n";
+#else
+const char s_eol[] = "\n";
+#endif
+
+enum class ReadResult { Ok, Malformed, NeedsQSettings };
+
+bool isSpace(char c)
 {
-    if (!contains("ConfigVersion"))
-        insert("ConfigVersion", "1.2");
-    QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
-    _settings_obj.setFallbacksEnabled(false);
-    _settings_obj.clear();
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+int digitValue(char c, int base)
+{
+    int value = -1;
+    if (c >= '0' && c <= '9')
+        value = c - '0';
+    else if (c >= 'a' && c <= 'f')
+        value = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+        value = c - 'A' + 10;
+    return value < base ? value : -1;
+}
+
+char simpleEscape(char code)
+{
+    switch (code) {
+        case 'a':
+            return '\a';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'v':
+            return '\v';
+        case '"':
+        case '?':
+        case '\'':
+        case '\\':
+            return code;
+        default:
+            return 0;
+    }
+}
+
+QString decode(const char* data, qsizetype size, bool utf8)
+{
+    return utf8 ? QString::fromUtf8(data, size) : QString::fromLatin1(data, size);
+}
+
+// Finds the next logical line: quotes and escaped line breaks continue it, and ';' starts a comment
+bool nextLine(const QByteArray& data, qsizetype& pos, qsizetype& lineStart, qsizetype& lineLen, qsizetype& equalsPos)
+{
+    const auto size = data.size();
+    bool inQuotes = false;
+    equalsPos = -1;
+
+    lineStart = pos;
+    while (lineStart < size && isSpace(data.at(lineStart)))
+        ++lineStart;
+
+    qsizetype i = lineStart;
+    bool lineEnded = false;
+    while (i < size && !lineEnded) {
+        const char ch = data.at(i++);
+        switch (ch) {
+            case '=':
+                if (!inQuotes && equalsPos == -1)
+                    equalsPos = i - 1;
+                break;
+            case '\n':
+            case '\r':
+                if (i == lineStart + 1) {
+                    ++lineStart;
+                } else if (!inQuotes) {
+                    --i;
+                    lineEnded = true;
+                }
+                break;
+            case '\\':
+                if (i < size) {
+                    const char escaped = data.at(i++);
+                    if (i < size) {
+                        const char next = data.at(i);
+                        if ((escaped == '\n' && next == '\r') || (escaped == '\r' && next == '\n'))
+                            ++i;
+                    }
+                }
+                break;
+            case '"':
+                inQuotes = !inQuotes;
+                break;
+            case ';':
+                if (i == lineStart + 1) {
+                    while (i < size && data.at(i) != '\n' && data.at(i) != '\r')
+                        ++i;
+                    while (i < size && isSpace(data.at(i)))
+                        ++i;
+                    lineStart = i;
+                } else if (!inQuotes) {
+                    --i;
+                    lineEnded = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    pos = i;
+    lineLen = i - lineStart;
+    return lineLen > 0;
+}
+
+// Keys escape what isn't [A-Za-z0-9_.-] as %XX or %UXXXX, and write the '/' of groups as '\'
+QString unescapeKey(const QByteArray& key, bool utf8)
+{
+    const QString decoded = decode(key.constData(), key.size(), utf8);
+    QString result;
+    result.reserve(decoded.size());
+
+    for (qsizetype i = 0; i < decoded.size();) {
+        const QChar ch = decoded.at(i);
+        if (ch == '\\') {
+            result += '/';
+            ++i;
+            continue;
+        }
+        if (ch != '%' || i == decoded.size() - 1) {
+            result += ch;
+            ++i;
+            continue;
+        }
+
+        auto first = i + 1;
+        int digits = 2;
+        if (decoded.at(first) == 'U') {
+            ++first;
+            digits = 4;
+        }
+
+        bool ok = false;
+        const ushort code = first + digits <= decoded.size() ? decoded.mid(first, digits).toUShort(&ok, 16) : 0;
+        if (!ok) {
+            result += '%';
+            ++i;
+            continue;
+        }
+        result += QChar(code);
+        i = first + digits;
+    }
+    return result;
+}
+
+void chopTrailingSpaces(QString& str, qsizetype limit)
+{
+    auto n = str.size();
+    while (n > limit && (str.at(n - 1) == ' ' || str.at(n - 1) == '\t'))
+        --n;
+    str.truncate(n);
+}
+
+// Unquotes and unescapes a value, returning whether it's a comma separated list
+bool unescapeValue(const char* str, qsizetype size, bool utf8, QString& result, QStringList& list)
+{
+    bool isList = false;
+    bool inQuotes = false;
+    bool quoted = false;
+    qsizetype i = 0;
+    qsizetype chopLimit = 0;
+
+    auto skipSpaces = [&] {
+        while (i < size && (str[i] == ' ' || str[i] == '\t'))
+            ++i;
+        chopLimit = result.size();
+    };
+
+    skipSpaces();
+    while (i < size) {
+        const char ch = str[i];
+        if (ch == '\\') {
+            if (++i >= size) {
+                chopLimit = result.size();
+                break;
+            }
+            const char code = str[i++];
+            if (char c = simpleEscape(code)) {
+                result += QLatin1Char(c);
+            } else if (code == 'x' || (code >= '0' && code <= '7')) {
+                const int base = code == 'x' ? 16 : 8;
+                ushort value = code == 'x' ? 0 : code - '0';
+                bool hasDigits = code != 'x';
+                int digit;
+                while (i < size && (digit = digitValue(str[i], base)) != -1) {
+                    value = value * base + digit;
+                    hasDigits = true;
+                    ++i;
+                }
+                if (hasDigits)
+                    result += QChar(value);
+            } else if (code == '\n' || code == '\r') {
+                if (i < size && (str[i] == '\n' || str[i] == '\r') && str[i] != code)
+                    ++i;
+            }
+            chopLimit = result.size();
+        } else if (ch == '"') {
+            ++i;
+            quoted = true;
+            inQuotes = !inQuotes;
+            if (!inQuotes)
+                skipSpaces();
+        } else if (ch == ',' && !inQuotes) {
+            if (!quoted)
+                chopTrailingSpaces(result, chopLimit);
+            isList = true;
+            list.append(result);
+            result.clear();
+            quoted = false;
+            ++i;
+            skipSpaces();
+        } else {
+            auto end = i + 1;
+            while (end < size && str[end] != '\\' && str[end] != '"' && str[end] != ',')
+                ++end;
+            result += decode(str + i, end - i, utf8);
+            i = end;
+        }
+    }
+
+    if (!quoted)
+        chopTrailingSpaces(result, chopLimit);
+    if (isList)
+        list.append(result);
+    return isList;
+}
+
+// Nothing if only QSettings can decode it
+std::optional<QVariant> stringToVariant(const QString& str)
+{
+    if (!str.startsWith('@'))
+        return QVariant(str);
+    if (str.startsWith("@@"))
+        return QVariant(str.mid(1));
+    if (!str.endsWith(')'))
+        return QVariant(str);
+
+    if (str.startsWith("@ByteArray("))
+        return QVariant(str.mid(11, str.size() - 12).toLatin1());
+    if (str.startsWith("@String("))
+        return QVariant(str.mid(8, str.size() - 9));
+    if (str == "@Invalid()")
+        return QVariant();
+    return {};
+}
+
+std::optional<QVariant> listToVariant(const QStringList& list)
+{
+    QStringList strings = list;
+    for (auto& str : strings) {
+        if (!str.startsWith('@'))
+            continue;
+        if (str.startsWith("@@")) {
+            str.remove(0, 1);
+            continue;
+        }
+
+        // something else than strings, so it's a QVariantList
+        QVariantList variants;
+        variants.reserve(list.size());
+        for (auto& item : list) {
+            auto variant = stringToVariant(item);
+            if (!variant)
+                return {};
+            variants.append(*variant);
+        }
+        return variants;
+    }
+    return strings;
+}
+
+ReadResult readIni(const QByteArray& data, QSettings::SettingsMap& map)
+{
+    qsizetype pos = 0;
+    bool utf8 = s_utf8;
+    if (data.startsWith("\xef\xbb\xbf")) {
+        pos = 3;
+        utf8 = true;
+    }
+
+    bool malformed = false;
+    QString section;
+    qsizetype lineStart, lineLen, equalsPos;
+    while (nextLine(data, pos, lineStart, lineLen, equalsPos)) {
+        const char first = data.at(lineStart);
+        if (first == '[') {
+            auto name = data.mid(lineStart + 1, lineLen - 1);
+            auto end = name.indexOf(']');
+            if (end == -1)
+                malformed = true;
+            else
+                name.truncate(end);
+            name = name.trimmed();
+
+            const auto lower = name.toLower();
+            if (lower == "general") {
+                section.clear();
+            } else {
+                section = lower == "%general" ? QString::fromLatin1(name.mid(1)) : unescapeKey(name, utf8);
+                section += '/';
+            }
+            continue;
+        }
+
+        if (equalsPos == -1) {
+            if (first != ';')
+                malformed = true;
+            continue;
+        }
+
+        const auto key = section + unescapeKey(data.mid(lineStart, equalsPos - lineStart).trimmed(), utf8);
+        const auto valueStart = equalsPos + 1;
+        QString string;
+        QStringList list;
+        std::optional<QVariant> value;
+        if (unescapeValue(data.constData() + valueStart, lineStart + lineLen - valueStart, utf8, string, list))
+            value = listToVariant(list);
+        else
+            value = stringToVariant(string);
+
+        if (!value)
+            return ReadResult::NeedsQSettings;
+        map.insert(key, *value);
+    }
+
+    return malformed ? ReadResult::Malformed : ReadResult::Ok;
+}
+
+bool readWithQSettings(const QByteArray& data, QSettings::SettingsMap& map)
+{
+    QTemporaryFile file;
+    if (!file.open())
+        return false;
+    file.write(data);
+    file.close();
+
+    QSettings settings{ file.fileName(), QSettings::Format::IniFormat };
+    settings.setFallbacksEnabled(false);
+
+    if (auto status = settings.status(); status != QSettings::Status::NoError) {
+        if (status == QSettings::Status::AccessError)
+            qCritical() << "An access error occurred (e.g. trying to write to a read-only file).";
+        if (status == QSettings::Status::FormatError)
+            qCritical() << "A format error occurred (e.g. loading a malformed INI file).";
+        return false;
+    }
+
+    for (auto&& key : settings.allKeys())
+        map.insert(key, settings.value(key));
+    return true;
+}
+
+void escapeKey(const QString& key, QByteArray& out)
+{
+    static const char hexDigits[] = "0123456789ABCDEF";
+    for (auto qch : key) {
+        const ushort ch = qch.unicode();
+        if (ch == '/') {
+            out += '\\';
+        } else if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' || ch == '-' ||
+                   ch == '.') {
+            out += static_cast<char>(ch);
+        } else if (ch <= 0xFF) {
+            out += '%';
+            out += hexDigits[ch / 16];
+            out += hexDigits[ch % 16];
+        } else {
+            out += "%U";
+            for (int shift = 12; shift >= 0; shift -= 4)
+                out += hexDigits[(ch >> shift) & 0xF];
+        }
+    }
+}
+
+void escapeString(const QString& str, QByteArray& out)
+{
+    const bool utf8 = s_utf8 && !str.startsWith("@ByteArray(") && !str.startsWith("@Variant(");
+    const auto start = out.size();
+    bool needsQuotes = false;
+    // "\x1" followed by "a" would read back as "\x1a"
+    bool escapeNextIfDigit = false;
+
+    for (qsizetype i = 0; i < str.size(); ++i) {
+        const ushort ch = str.at(i).unicode();
+        if (ch == ';' || ch == ',' || ch == '=')
+            needsQuotes = true;
+
+        if (escapeNextIfDigit && ch < 0x80 && digitValue(static_cast<char>(ch), 16) != -1) {
+            out += "\\x" + QByteArray::number(uint(ch), 16);
+            continue;
+        }
+        escapeNextIfDigit = false;
+
+        switch (ch) {
+            case '\0':
+                out += "\\0";
+                escapeNextIfDigit = true;
+                break;
+            case '\a':
+                out += "\\a";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            case '\v':
+                out += "\\v";
+                break;
+            case '"':
+            case '\\':
+                out += '\\';
+                out += static_cast<char>(ch);
+                break;
+            default:
+                if (ch <= 0x1F || (ch >= 0x7F && !utf8)) {
+                    out += "\\x" + QByteArray::number(uint(ch), 16);
+                    escapeNextIfDigit = true;
+                } else if (ch >= 0x80) {
+                    // a surrogate pair has to be encoded as a whole
+                    const qsizetype len = str.at(i).isHighSurrogate() && i + 1 < str.size() && str.at(i + 1).isLowSurrogate() ? 2 : 1;
+                    out += str.mid(i, len).toUtf8();
+                    i += len - 1;
+                } else {
+                    out += static_cast<char>(ch);
+                }
+        }
+    }
+
+    if (needsQuotes || (start < out.size() && (out.at(start) == ' ' || out.at(out.size() - 1) == ' '))) {
+        out.insert(start, '"');
+        out += '"';
+    }
+}
+
+// Nothing if only QSettings can encode it
+std::optional<QString> variantToString(const QVariant& value)
+{
+    switch (value.userType()) {
+        case QMetaType::UnknownType:
+            return QString("@Invalid()");
+        case QMetaType::QByteArray: {
+            const auto bytes = value.toByteArray();
+            return "@ByteArray(" + QString::fromLatin1(bytes.constData(), bytes.size()) + ")";
+        }
+        case QMetaType::QString:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Bool:
+        case QMetaType::Double: {
+            auto str = value.toString();
+            if (str.contains(QChar::Null))
+                return "@String(" + str + ")";
+            if (str.startsWith('@'))
+                str.prepend('@');
+            return str;
+        }
+        default:
+            return {};
+    }
+}
+
+std::optional<QByteArray> writeIni(const QMap<QString, QVariant>& map)
+{
+    // keys are grouped by their first component, the rest goes to [General]
+    QMap<QString, QByteArray> sections;
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        const auto slash = it.key().indexOf('/');
+        auto& block = sections[slash == -1 ? QString() : it.key().left(slash)];
+        escapeKey(slash == -1 ? it.key() : it.key().mid(slash + 1), block);
+        block += '=';
+
+        const auto& value = it.value();
+        const auto type = value.userType();
+        if (type == QMetaType::QStringList || (type == QMetaType::QVariantList && value.toList().size() != 1)) {
+            const auto items = value.toList();
+            if (items.isEmpty())
+                block += "@Invalid()";
+            for (qsizetype i = 0; i < items.size(); ++i) {
+                auto str = variantToString(items.at(i));
+                if (!str)
+                    return {};
+                if (i != 0)
+                    block += ", ";
+                escapeString(*str, block);
+            }
+        } else {
+            auto str = variantToString(value);
+            if (!str)
+                return {};
+            escapeString(*str, block);
+        }
+        block += s_eol;
+    }
+
+    QByteArray data;
+    for (auto it = sections.cbegin(); it != sections.cend(); ++it) {
+        if (!data.isEmpty())
+            data += s_eol;
+        if (it.key().isEmpty()) {
+            data += "[General]";
+        } else if (it.key().compare(QLatin1String("general"), Qt::CaseInsensitive) == 0) {
+            data += "[%General]";
+        } else {
+            data += '[';
+            escapeKey(it.key(), data);
+            data += ']';
+        }
+        data += s_eol;
+        data += it.value();
+    }
+    return data;
+}
+
+bool writeWithQSettings(const QMap<QString, QVariant>& map, const QString& fileName)
+{
+    QSettings settings{ fileName, QSettings::Format::IniFormat };
+    settings.setFallbacksEnabled(false);
+    settings.clear();
 
-    for (Iterator iter = begin(); iter != end(); iter++)
-        _settings_obj.setValue(iter.key(), iter.value());
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        settings.setValue(it.key(), it.value());
 
-    _settings_obj.sync();
+    settings.sync();
 
-    if (auto status = _settings_obj.status(); status != QSettings::Status::NoError) {
+    if (auto status = settings.status(); status != QSettings::Status::NoError) {
         // Shouldn't be possible!
         Q_ASSERT(status != QSettings::Status::FormatError);
 
@@ -73,6 +626,27 @@ bool INIFile::saveFile(QString fileName)
 
     return true;
 }
+}  // namespace
+
+INIFile::INIFile() {}
+
+bool INIFile::saveFile(QString fileName)
+{
+    if (!contains("ConfigVersion"))
+        insert("ConfigVersion", "1.2");
+
+    auto data = writeIni(*this);
+    if (!data)
+        return writeWithQSettings(*this, fileName);
+
+    try {
+        FS::write(fileName, *data);
+    } catch (const FS::FileSystemException& e) {
+        qCritical() << "Failed to save" << fileName << ":" << e.cause();
+        return false;
+    }
+    return true;
+}
 
 QString unescape(QString orig)
 {
@@ -152,55 +726,56 @@ bool parseOldFileFormat(QIODevice& device, QSettings::SettingsMap& map)
 
 bool INIFile::loadFile(QString fileName)
 {
-    QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
-    _settings_obj.setFallbacksEnabled(false);
-
-    if (auto status = _settings_obj.status(); status != QSettings::Status::NoError) {
-        if (status == QSettings::Status::AccessError)
-            qCritical() << "An access error occurred (e.g. trying to write to a read-only file).";
-        if (status == QSettings::Status::FormatError)
-            qCritical() << "A format error occurred (e.g. loading a malformed INI file).";
+    QFile file(fileName);
+    if (!file.exists())
+        return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "An access error occurred (e.g. trying to read a protected file).";
         return false;
     }
-    if (!_settings_obj.value("ConfigVersion").isValid()) {
-        QFile file(fileName);
-        if (!file.open(QIODevice::ReadOnly))
+    return loadFile(file.readAll());
+}
+
+bool INIFile::loadFile(QByteArray data)
+{
+    QSettings::SettingsMap map;
+    switch (readIni(data, map)) {
+        case ReadResult::Ok:
+            break;
+        case ReadResult::Malformed:
+            qCritical() << "A format error occurred (e.g. loading a malformed INI file).";
             return false;
-        QSettings::SettingsMap map;
-        parseOldFileFormat(file, map);
-        file.close();
-        for (auto&& key : map.keys())
-            insert(key, map.value(key));
+        case ReadResult::NeedsQSettings:
+            map.clear();
+            if (!readWithQSettings(data, map))
+                return false;
+            break;
+    }
+
+    if (!map.value("ConfigVersion").isValid()) {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QSettings::SettingsMap oldMap;
+        parseOldFileFormat(buffer, oldMap);
+        for (auto it = oldMap.cbegin(); it != oldMap.cend(); ++it)
+            insert(it.key(), it.value());
         insert("ConfigVersion", "1.2");
-    } else if (_settings_obj.value("ConfigVersion").toString() == "1.1") {
-        for (auto&& key : _settings_obj.allKeys()) {
-            if (auto valueStr = _settings_obj.value(key).toString();
+    } else if (map.value("ConfigVersion").toString() == "1.1") {
+        for (auto it = map.cbegin(); it != map.cend(); ++it) {
+            if (auto valueStr = it.value().toString();
                 (valueStr.contains(QChar(';')) || valueStr.contains(QChar('=')) || valueStr.contains(QChar(','))) &&
                 valueStr.endsWith("\"") && valueStr.startsWith("\"")) {
-                insert(key, unquote(valueStr));
+                insert(it.key(), unquote(valueStr));
             } else
-                insert(key, _settings_obj.value(key));
+                insert(it.key(), it.value());
         }
         insert("ConfigVersion", "1.2");
     } else
-        for (auto&& key : _settings_obj.allKeys())
-            insert(key, _settings_obj.value(key));
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            insert(it.key(), it.value());
     return true;
 }
 
-bool INIFile::loadFile(QByteArray data)
-{
-    QTemporaryFile file;
-    if (!file.open())
-        return false;
-    file.write(data);
-    file.flush();
-    file.close();
-    auto loaded = loadFile(file.fileName());
-    file.remove();
-    return loaded;
-}
-
 QVariant INIFile::get(QString key, QVariant def) const
 {
     if (!this->contains(key))
@@ -16,8 +16,42 @@
 #include "INISettingsObject.h"
 #include "Setting.h"
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+// Shared between a settings object and its writes in the background, so an older write never lands after a newer one
+struct INISettingsObject::SaveState {
+    QMutex mutex;
+    quint64 written = 0;
+};
+
+namespace {
+// How long changes are collected before they're written out together
+constexpr int saveDelayMs = 1000;
+
+void writeSnapshot(std::shared_ptr<INISettingsObject::SaveState> state, quint64 generation, INIFile ini, QString path)
+{
+    QMutexLocker locker(&state->mutex);
+    // something newer is already on disk
+    if (generation <= state->written)
+        return;
+
+    // The folder was deleted or moved since the change, don't bring it back with just the settings in it.
+    // Nothing got written, so it's not recorded as such either.
+    if (!QFileInfo(path).dir().exists()) {
+        qDebug() << "Not saving" << path << "as its folder is gone";
+        return;
+    }
+    state->written = generation;
+    if (!ini.saveFile(path))
+        qWarning() << "Failed to save" << path;
+}
+}  // namespace
 
 INISettingsObject::INISettingsObject(QStringList paths, QObject* parent) : SettingsObject(parent)
 {
@@ -36,21 +70,48 @@ INISettingsObject::INISettingsObject(QStringList paths, QObject* parent) : Setti
 
     m_filePath = first_path;
     m_ini.loadFile(first_path);
+    setupSaving();
 }
 
 INISettingsObject::INISettingsObject(QString path, QObject* parent) : SettingsObject(parent)
 {
     m_filePath = path;
     m_ini.loadFile(path);
+    setupSaving();
+}
+
+INISettingsObject::INISettingsObject(QString path, INIFile ini, QObject* parent)
+    : SettingsObject(parent), m_ini(std::move(ini)), m_filePath(std::move(path))
+{
+    setupSaving();
+}
+
+INISettingsObject::~INISettingsObject()
+{
+    flush();
+}
+
+void INISettingsObject::setupSaving()
+{
+    m_saveState = std::make_shared<SaveState>();
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_saveTimer, &QTimer::timeout, this, &INISettingsObject::saveInBackground);
+
+    if (auto app = QCoreApplication::instance())
+        connect(app, &QCoreApplication::aboutToQuit, this, &INISettingsObject::flush);
 }
 
 void INISettingsObject::setFilePath(const QString& filePath)
 {
+    flush();
     m_filePath = filePath;
 }
 
 bool INISettingsObject::reload()
 {
+    flush();
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
@@ -63,7 +124,10 @@ void INISettingsObject::resumeSave()
 {
     m_suspendSave = false;
     if (m_doSave) {
-        m_ini.saveFile(m_filePath);
+        m_doSave = false;
+        // the end of a batch of changes, whoever made them expects them to be on disk now
+        m_dirty = true;
+        flush();
     }
 }
 
@@ -90,9 +154,34 @@ void INISettingsObject::doSave()
 {
     if (m_suspendSave) {
         m_doSave = true;
-    } else {
-        m_ini.saveFile(m_filePath);
+        return;
+    }
+
+    // Not restarted on every change, so a steady stream of them still gets written out regularly
+    m_dirty = true;
+    if (!m_saveTimer.isActive())
+        m_saveTimer.start(saveDelayMs);
+}
+
+void INISettingsObject::saveInBackground()
+{
+    if (!m_dirty)
+        return;
+    m_dirty = false;
+    QtConcurrent::run(QThreadPool::globalInstance(), writeSnapshot, m_saveState, ++m_generation, m_ini, m_filePath);
+}
+
+void INISettingsObject::flush()
+{
+    m_saveTimer.stop();
+    if (!m_dirty) {
+        // the last change may still be on its way to disk in the background
+        QMutexLocker locker(&m_saveState->mutex);
+        if (m_saveState->written == m_generation)
+            return;
     }
+    m_dirty = false;
+    writeSnapshot(m_saveState, ++m_generation, m_ini, m_filePath);
 }
 
 void INISettingsObject::resetSetting(const Setting& setting)
@@ -16,6 +16,9 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
+
+#include <memory>
 
 #include "settings/INIFile.h"
 
@@ -32,6 +35,13 @@ class INISettingsObject : public SettingsObject {
 
     explicit INISettingsObject(QString path, QObject* parent = nullptr);
 
+    /** For an INI file at 'path' that was already read into 'ini', e.g. on another thread. */
+    INISettingsObject(QString path, INIFile ini, QObject* parent = nullptr);
+
+    ~INISettingsObject() override;
+
+    struct SaveState;
+
     /*!
      * \brief Gets the path to the INI file.
      * \return The path to the INI file.
@@ -49,6 +59,13 @@ class INISettingsObject : public SettingsObject {
     void suspendSave() override;
     void resumeSave() override;
 
+   public slots:
+    /*!
+     * \brief Writes out the pending changes right away, instead of when the save timer runs out.
+     * Changes are otherwise saved a moment after they're made, on a worker thread.
+     */
+    void flush() override;
+
    protected slots:
     virtual void changeSetting(const Setting& setting, QVariant value) override;
     virtual void resetSetting(const Setting& setting) override;
@@ -57,7 +74,19 @@ class INISettingsObject : public SettingsObject {
     virtual QVariant retrieveValue(const Setting& setting) override;
     void doSave();
 
+   private slots:
+    void saveInBackground();
+
+   private:
+    void setupSaving();
+
    protected:
     INIFile m_ini;
     QString m_filePath;
+
+   private:
+    QTimer m_saveTimer;
+    bool m_dirty = false;
+    quint64 m_generation = 0;
+    std::shared_ptr<SaveState> m_saveState;
 };
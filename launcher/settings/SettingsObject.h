@@ -141,6 +141,12 @@ class SettingsObject : public QObject {
 
     virtual void suspendSave() = 0;
     virtual void resumeSave() = 0;
+
+    /*!
+     * \brief Writes out the changes that are still waiting to be saved.
+     * Call it before anything else reads the settings file, like copying or exporting an instance.
+     */
+    virtual void flush() = 0;
    signals:
     /*!
      * \brief Signal emitted when one of this SettingsObject object's settings changes.
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ThenTask.h"
+
+#include <QDebug>
+#include <QHash>
+
+#include "tasks/ConcurrentTask.h"
+
+ThenTask::ThenTask(Task::Ptr first, Continuation next, QObject* parent) : Task(parent), m_first(std::move(first)), m_next(std::move(next))
+{}
+
+bool ThenTask::canAbort() const
+{
+    return !m_current || m_current->canAbort();
+}
+
+bool ThenTask::abort()
+{
+    m_next = nullptr;
+
+    if (m_current && m_current->isRunning())
+        return m_current->abort();
+
+    if (isRunning())
+        emitAborted();
+    return true;
+}
+
+void ThenTask::executeTask()
+{
+    runStep(std::exchange(m_first, nullptr), m_next == nullptr);
+}
+
+void ThenTask::runStep(Task::Ptr step, bool last)
+{
+    if (!step) {
+        stepSucceeded(last);
+        return;
+    }
+
+    if (step->isFinished()) {
+        if (step->wasSuccessful())
+            stepSucceeded(last);
+        else if (step->getState() == State::AbortedByUser)
+            emitAborted();
+        else
+            stepFailed(last, step->failReason());
+        return;
+    }
+
+    m_current = step;
+
+    connect(step.get(), &Task::status, this, &ThenTask::setStatus);
+    connect(step.get(), &Task::details, this, &ThenTask::setDetails);
+    connect(step.get(), &Task::progress, this, &ThenTask::setProgress);
+    connect(step.get(), &Task::stepProgress, this, &ThenTask::propagateStepProgress);
+    connect(step.get(), &Task::abortStatusChanged, this, &ThenTask::abortStatusChanged);
+
+    connect(step.get(), &Task::succeeded, this, [this, last] {
+        releaseStep();
+        stepSucceeded(last);
+    });
+    connect(step.get(), &Task::failed, this, [this, last](QString reason) {
+        releaseStep();
+        stepFailed(last, reason);
+    });
+    connect(step.get(), &Task::aborted, this, [this] {
+        releaseStep();
+        emitAborted();
+    });
+
+    if (!step->isRunning())
+        step->start();
+}
+
+void ThenTask::stepSucceeded(bool last)
+{
+    if (last || !m_next) {
+        emitSucceeded();
+        return;
+    }
+
+    auto next = std::exchange(m_next, nullptr);
+    runStep(next(), true);
+}
+
+void ThenTask::stepFailed(bool last, const QString& reason)
+{
+    if (last || !m_next || !m_continue_on_failure) {
+        emitFailed(reason);
+        return;
+    }
+
+    qWarning() << "Carrying on after a failed step of" << describe() << ":" << reason;
+    stepSucceeded(last);
+}
+
+void ThenTask::releaseStep()
+{
+    // Only dropped later on, since we're usually inside one of its signals
+    disconnect(m_current.get(), nullptr, this, nullptr);
+    m_current.reset();
+}
+
+namespace Tasks {
+
+Task::Ptr whenAll(const QList<Task::Ptr>& tasks, int max_concurrent)
+{
+    auto all = makeShared<ConcurrentTask>(nullptr, "WhenAll", max_concurrent);
+    for (auto& task : tasks) {
+        if (!task)
+            continue;
+        // Restarting those would throw their work (or their result) away, so they're waited for instead
+        if (task->isRunning() || task->isFinished())
+            all->addTask(makeShared<ThenTask>(task, ThenTask::Continuation()));
+        else
+            all->addTask(task);
+    }
+    return all;
+}
+
+void startDetached(Task::Ptr task)
+{
+    static QHash<Task*, Task::Ptr> s_detached;
+
+    if (!task)
+        return;
+
+    s_detached.insert(task.get(), task);
+    QObject::connect(task.get(), &Task::finished, [raw = task.get()] { s_detached.remove(raw); });
+
+    if (!task->isRunning())
+        task->start();
+}
+
+}  // namespace Tasks
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "tasks/Task.h"
+
+/** Runs a task, and then the one a continuation makes once the first one succeeded.
+ *
+ *  The continuation is only called after the first task succeeded, so it can use whatever that task produced
+ *  to decide what to do next, and may return nullptr if there's nothing left to do. If either step fails or
+ *  is aborted, so is the whole chain.
+ *
+ *  A first task that is already running is waited for instead of being started again, and one that already
+ *  finished is taken as it is, so tasks shared with other users (like the metadata load tasks) can be chained too.
+ *
+ *  See Tasks::then() for the usual way of making one, and Tasks::afterFinished() for one carrying on after a failure.
+ */
+class ThenTask : public Task {
+    Q_OBJECT
+   public:
+    using Continuation = std::function<Task::Ptr()>;
+
+    ThenTask(Task::Ptr first, Continuation next, QObject* parent = nullptr);
+    ~ThenTask() override = default;
+
+    bool canAbort() const override;
+
+    /** Runs the continuation even if the first task failed. Aborting still stops the chain. */
+    void setContinueOnFailure(bool continue_on_failure) { m_continue_on_failure = continue_on_failure; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void runStep(Task::Ptr step, bool last);
+    void stepSucceeded(bool last);
+    void stepFailed(bool last, const QString& reason);
+    void releaseStep();
+
+   private:
+    Task::Ptr m_first;
+    Continuation m_next;
+    bool m_continue_on_failure = false;
+
+    Task::Ptr m_current;
+};
+
+namespace Tasks {
+
+namespace detail {
+template <typename F>
+shared_qobject_ptr<ThenTask> makeThenTask(Task::Ptr first, F next)
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
+        return makeShared<ThenTask>(std::move(first), ThenTask::Continuation([next]() mutable -> Task::Ptr {
+                                        next();
+                                        return nullptr;
+                                    }));
+    } else {
+        return makeShared<ThenTask>(std::move(first), ThenTask::Continuation(std::move(next)));
+    }
+}
+}  // namespace detail
+
+/** Chains 'next' after 'first'. 'next' either returns the Task::Ptr to run afterwards, or nothing at all. */
+template <typename F>
+Task::Ptr then(Task::Ptr first, F next)
+{
+    return detail::makeThenTask(std::move(first), std::move(next));
+}
+
+/** Like then(), but 'next' also runs when 'first' failed, for steps that can leave something usable behind even then
+ *  (like a metadata refresh, which keeps the local copy loaded when the remote one can't be had). */
+template <typename F>
+Task::Ptr afterFinished(Task::Ptr first, F next)
+{
+    auto task = detail::makeThenTask(std::move(first), std::move(next));
+    task->setContinueOnFailure(true);
+    return task;
+}
+
+/** A task running all of 'tasks', at most 'max_concurrent' at a time, which only succeeds if all of them do.
+ *  Null tasks are skipped, and the ones already running or finished are waited for / taken as they are. */
+Task::Ptr whenAll(const QList<Task::Ptr>& tasks, int max_concurrent = 6);
+
+/** Starts 'task' and keeps it alive until it finished, for fire-and-forget work nobody waits on. Must be called from the GUI thread. */
+void startDetached(Task::Ptr task);
+
+}  // namespace Tasks
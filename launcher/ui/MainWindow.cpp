@@ -122,6 +122,8 @@
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
 
+#include "tasks/ThenTask.h"
+
 #include "KonamiCode.h"
 
 #include "InstanceCopyTask.h"
@@ -1063,9 +1065,16 @@ void MainWindow::processURLs(QList<QUrl> urls)
             case PackedResourceType::DataPack:
                 qWarning() << "Importing of Data Packs not supported at this time. Ignoring" << localFileName;
                 break;
-            case PackedResourceType::Mod:
-                minecraftInst->loaderModList()->installMod(localFileName, version);
+            case PackedResourceType::Mod: {
+                auto task = minecraftInst->loaderModList()->installMod(localFileName, version);
+                connect(task.get(), &Task::failed, this, [this, localFileName](QString reason) {
+                    CustomMessageBox::selectable(this, tr("Error"), tr("Failed to install %1:\n%2").arg(localFileName, reason),
+                                                 QMessageBox::Warning)
+                        ->show();
+                });
+                Tasks::startDetached(task);
                 break;
+            }
             case PackedResourceType::ShaderPack:
                 minecraftInst->shaderPackList()->installResource(localFileName);
                 break;
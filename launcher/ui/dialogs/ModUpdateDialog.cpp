@@ -8,6 +8,7 @@
 #include "modplatform/flame/FlameAPI.h"
 #include "ui_ReviewMessageBox.h"
 
+#include "Json.h"
 #include "Markdown.h"
 
 #include "tasks/ConcurrentTask.h"
@@ -19,6 +20,7 @@
 #include "modplatform/flame/FlameCheckUpdate.h"
 #include "modplatform/modrinth/ModrinthCheckUpdate.h"
 
+#include <QPointer>
 #include <QTextBrowser>
 #include <QTreeWidgetItem>
 
@@ -54,6 +56,8 @@ ModUpdateDialog::ModUpdateDialog(QWidget* parent,
 
     ui->explainLabel->setText(tr("You're about to update the following mods:"));
     ui->onlyCheckedLabel->setText(tr("Only mods with a check will be updated!"));
+
+    connect(ui->modTreeWidget, &QTreeWidget::itemExpanded, this, &ModUpdateDialog::loadChangelog);
 }
 
 void ModUpdateDialog::checkCandidates()
@@ -212,14 +216,10 @@ void ModUpdateDialog::checkCandidates()
             QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
             return;
         }
-        static FlameAPI api;
-
         auto getRequiredBy = depTask->getRequiredBy();
 
         for (auto dep : depTask->getDependecies()) {
             auto changelog = dep->version.changelog;
-            if (dep->pack->provider == ModPlatform::ResourceProvider::FLAME)
-                changelog = api.getModFileChangelog(dep->version.addonId.toInt(), dep->version.fileId.toInt());
             auto download_task = makeShared<ResourceDownloadTask>(dep->pack, dep->version, m_mod_model);
             CheckUpdateTask::UpdatableMod updatable = {
                 dep->pack->name, dep->version.hash,   "",           dep->version.version, dep->version.version_type,
@@ -471,9 +471,53 @@ void ModUpdateDialog::appendMod(CheckUpdateTask::UpdatableMod const& info, QStri
 
     ui->modTreeWidget->setItemWidget(changelog, 0, changelog_area);
 
+    // CurseForge changelogs need a request each, so only get them when they're looked at
+    if (text.isEmpty() && info.provider == ModPlatform::ResourceProvider::FLAME && info.download)
+        m_lazy_changelogs.insert(changelog_item, info.download->getVersion());
+
     ui->modTreeWidget->addTopLevelItem(item_top);
 }
 
+void ModUpdateDialog::loadChangelog(QTreeWidgetItem* item)
+{
+    auto it = m_lazy_changelogs.find(item);
+    if (it == m_lazy_changelogs.end())
+        return;
+    auto version = it.value();
+    m_lazy_changelogs.erase(it);
+
+    QPointer<QTextBrowser> changelog_area = qobject_cast<QTextBrowser*>(ui->modTreeWidget->itemWidget(item->child(0), 0));
+    if (!changelog_area)
+        return;
+    changelog_area->setPlainText(tr("Loading changelog..."));
+
+    static FlameAPI api;
+    auto response = std::make_shared<QByteArray>();
+    auto job = api.getModFileChangelog(version.addonId.toInt(), version.fileId.toInt(), response);
+
+    connect(job.get(), &Task::succeeded, this, [changelog_area, response] {
+        if (!changelog_area)
+            return;
+
+        QJsonParseError parse_error{};
+        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+        if (parse_error.error != QJsonParseError::NoError) {
+            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
+                       << " reason: " << parse_error.errorString();
+            changelog_area->setPlainText(tr("Failed to load the changelog."));
+            return;
+        }
+        changelog_area->setHtml(Json::ensureString(doc.object(), "data"));
+    });
+    connect(job.get(), &Task::failed, this, [changelog_area](QString reason) {
+        if (changelog_area)
+            changelog_area->setPlainText(tr("Failed to load the changelog: %1").arg(reason));
+    });
+
+    m_changelog_jobs.append(job);
+    job->start();
+}
+
 auto ModUpdateDialog::getTasks() -> const QList<ResourceDownloadTask::Ptr>
 {
     QList<ResourceDownloadTask::Ptr> list;
@@ -12,6 +12,7 @@ class Mod;
 class ModrinthCheckUpdate;
 class FlameCheckUpdate;
 class ConcurrentTask;
+class QTreeWidgetItem;
 
 class ModUpdateDialog final : public ReviewMessageBox {
     Q_OBJECT
@@ -41,6 +42,7 @@ class ModUpdateDialog final : public ReviewMessageBox {
     void onMetadataFailed(Mod*,
                           bool try_others = false,
                           ModPlatform::ResourceProvider first_choice = ModPlatform::ResourceProvider::MODRINTH);
+    void loadChangelog(QTreeWidgetItem* item);
 
    private:
     QWidget* m_parent;
@@ -59,6 +61,10 @@ class ModUpdateDialog final : public ReviewMessageBox {
     QList<std::tuple<Mod*, QString, QUrl>> m_failed_check_update;
 
     QHash<QString, ResourceDownloadTask::Ptr> m_tasks;
+    /* Changelog items whose text is only fetched once they're expanded */
+    QHash<QTreeWidgetItem*, ModPlatform::IndexedVersion> m_lazy_changelogs;
+    /* Kept around until the dialog closes, there's only one per changelog anyway */
+    QList<Task::Ptr> m_changelog_jobs;
     BaseInstance* m_instance;
 
     bool m_no_updates = false;
@@ -45,6 +45,7 @@
 #include <QHeaderView>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QScrollBar>
 #include <algorithm>
 
 ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared_ptr<ResourceFolderModel> model, QWidget* parent)
@@ -91,6 +92,11 @@ ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared
 
     connect(ui->filterEdit, &QLineEdit::textChanged, this, &ExternalResourcesPage::filterTextChanged);
 
+    // parse what the user is looking at first
+    connect(model.get(), &ResourceFolderModel::updateFinished, this, &ExternalResourcesPage::prioritizeVisibleRows);
+    connect(ui->treeView->verticalScrollBar(), &QScrollBar::valueChanged, this, &ExternalResourcesPage::prioritizeVisibleRows);
+    connect(m_filterModel, &QSortFilterProxyModel::layoutChanged, this, &ExternalResourcesPage::prioritizeVisibleRows);
+
     auto viewHeader = ui->treeView->header();
     viewHeader->setContextMenuPolicy(Qt::CustomContextMenu);
 
@@ -126,6 +132,19 @@ void ExternalResourcesPage::ShowHeaderContextMenu(const QPoint& pos)
     menu->deleteLater();
 }
 
+void ExternalResourcesPage::prioritizeVisibleRows()
+{
+    auto view = ui->treeView;
+    auto const viewport_height = view->viewport()->height();
+
+    QList<int> rows;
+    for (auto index = view->indexAt({ 0, 0 }); index.isValid() && view->visualRect(index).top() < viewport_height;
+         index = view->indexBelow(index)) {
+        rows.append(m_filterModel->mapToSource(index).row());
+    }
+    m_model->prioritizeRows(rows);
+}
+
 void ExternalResourcesPage::openedImpl()
 {
     m_model->startWatching();
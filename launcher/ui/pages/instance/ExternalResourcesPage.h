@@ -63,6 +63,8 @@ class ExternalResourcesPage : public QMainWindow, public BasePage {
     void ShowContextMenu(const QPoint& pos);
     void ShowHeaderContextMenu(const QPoint& pos);
 
+    void prioritizeVisibleRows();
+
    protected:
     BaseInstance* m_instance = nullptr;
 
@@ -502,7 +502,29 @@ void FlameManagedPackPage::suggestVersion()
     }
     auto version = m_pack.versions.at(index);
 
-    ui->changelogTextBrowser->setHtml(m_api.getModFileChangelog(m_inst->getManagedPackID().toInt(), version.fileId));
+    if (m_changelog_job && m_changelog_job->isRunning())
+        m_changelog_job->abort();
+
+    ui->changelogTextBrowser->setText(tr("Loading changelog..."));
+
+    auto response = std::make_shared<QByteArray>();
+    m_changelog_job = m_api.getModFileChangelog(m_inst->getManagedPackID().toInt(), version.fileId, response);
+    QObject::connect(m_changelog_job.get(), &Task::succeeded, this, [this, response] {
+        QJsonParseError parse_error{};
+        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+        if (parse_error.error != QJsonParseError::NoError) {
+            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
+                       << " reason: " << parse_error.errorString();
+            qWarning() << *response;
+            ui->changelogTextBrowser->setText(tr("Couldn't load changelog"));
+            return;
+        }
+
+        ui->changelogTextBrowser->setHtml(Json::ensureString(doc.object(), "data"));
+    });
+    QObject::connect(m_changelog_job.get(), &Task::failed, this,
+                     [this] { ui->changelogTextBrowser->setText(tr("Couldn't load changelog")); });
+    m_changelog_job->start();
 
     ManagedPackPage::suggestVersion();
 }
@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// MurmurHash2 was written by Austin Appleby, and is placed in the public
+// domain. The author hereby disclaims copyright to this source code.
+//
+// The whitespace filtering kernels below are also placed in the public domain,
+// and the author of such modifications hereby disclaims copyright to this source code.
+
+#include "MurmurHash2.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define MURMUR2_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 needs per-function target attributes and a way to ask the CPU, which only GCC and Clang give us
+#if defined(MURMUR2_HAVE_SSE2) && (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define MURMUR2_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+const uint32_t m = 0x5bd1e995;
+const int r = 24;
+
+inline bool isWhitespace(unsigned char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+inline uint32_t load32(const unsigned char* data)
+{
+    // same byte order as the reinterpret_cast in FourBytes_MurmurHash2, without the alignment requirement
+    uint32_t k;
+    std::memcpy(&k, data, sizeof(k));
+    return k;
+}
+
+inline int popcount32(uint32_t x)
+{
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F;
+    return static_cast<int>((x * 0x01010101) >> 24);
+}
+
+// Mixes the kept bytes into the hash a word at a time, holding back the ones that don't make a whole word yet
+class Writer {
+   public:
+    // This forces a seed of 1.
+    explicit Writer(uint32_t len) : m_h(1 ^ len) {}
+
+    void put(unsigned char c)
+    {
+        m_tail[m_tail_size++] = c;
+        if (m_tail_size == 4) {
+            mix(load32(m_tail));
+            m_tail_size = 0;
+        }
+    }
+
+    // Every byte of 'data' is kept
+    void putRun(const unsigned char* data, std::size_t size)
+    {
+        std::size_t i = 0;
+        while (m_tail_size != 0 && i < size)
+            put(data[i++]);
+        for (; i + 4 <= size; i += 4)
+            mix(load32(data + i));
+        for (; i < size; i++)
+            put(data[i]);
+    }
+
+    // Keeps the bytes of 'data' whose bit in 'skip' is clear
+    void putMasked(const unsigned char* data, std::size_t size, uint32_t skip)
+    {
+        std::size_t start = 0;
+        while (skip != 0) {
+            std::size_t end = 0;
+            while (!(skip & (1u << end)))
+                end++;
+            if (end > start)
+                putRun(data + start, end - start);
+            skip &= ~(1u << end);
+            start = end + 1;
+        }
+        if (size > start)
+            putRun(data + start, size - start);
+    }
+
+    uint32_t finish()
+    {
+        // Handle the last few bytes of the input array
+        switch (m_tail_size) {
+            case 3:
+                m_h ^= m_tail[2] << 16;
+                /* fall through */
+            case 2:
+                m_h ^= m_tail[1] << 8;
+                /* fall through */
+            case 1:
+                m_h ^= m_tail[0];
+                m_h *= m;
+        };
+
+        // Do a few final mixes of the hash to ensure the last few
+        // bytes are well-incorporated.
+        m_h ^= m_h >> 13;
+        m_h *= m;
+        m_h ^= m_h >> 15;
+
+        return m_h;
+    }
+
+   private:
+    void mix(uint32_t k)
+    {
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        m_h *= m;
+        m_h ^= k;
+    }
+
+    uint32_t m_h;
+    unsigned char m_tail[4];
+    int m_tail_size = 0;
+};
+
+uint32_t scalarKernel(const unsigned char* data, std::size_t size)
+{
+    uint32_t len = 0;
+    for (std::size_t i = 0; i < size; i++)
+        len += !isWhitespace(data[i]);
+
+    Writer writer(len);
+    for (std::size_t i = 0; i < size; i++) {
+        if (!isWhitespace(data[i]))
+            writer.put(data[i]);
+    }
+    return writer.finish();
+}
+
+#ifdef MURMUR2_HAVE_SSE2
+inline uint32_t whitespaceMask(__m128i v)
+{
+    auto ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(9)), _mm_cmpeq_epi8(v, _mm_set1_epi8(10))),
+                           _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(13)), _mm_cmpeq_epi8(v, _mm_set1_epi8(32))));
+    return static_cast<uint32_t>(_mm_movemask_epi8(ws));
+}
+
+uint32_t sse2Kernel(const unsigned char* data, std::size_t size)
+{
+    const std::size_t blocks = size & ~std::size_t(15);
+
+    uint32_t whitespace = 0;
+    for (std::size_t i = 0; i < blocks; i += 16)
+        whitespace += popcount32(whitespaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))));
+    for (std::size_t i = blocks; i < size; i++)
+        whitespace += isWhitespace(data[i]);
+
+    Writer writer(static_cast<uint32_t>(size) - whitespace);
+    for (std::size_t i = 0; i < blocks; i += 16) {
+        auto mask = whitespaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        if (mask == 0)
+            writer.putRun(data + i, 16);
+        else
+            writer.putMasked(data + i, 16, mask);
+    }
+    for (std::size_t i = blocks; i < size; i++) {
+        if (!isWhitespace(data[i]))
+            writer.put(data[i]);
+    }
+    return writer.finish();
+}
+#endif
+
+#ifdef MURMUR2_HAVE_AVX2
+__attribute__((target("avx2"))) inline uint32_t whitespaceMask256(__m256i v)
+{
+    auto ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(9)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(10))),
+                              _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(13)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(32))));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+}
+
+__attribute__((target("avx2"))) uint32_t avx2Kernel(const unsigned char* data, std::size_t size)
+{
+    const std::size_t blocks = size & ~std::size_t(31);
+
+    uint32_t whitespace = 0;
+    for (std::size_t i = 0; i < blocks; i += 32)
+        whitespace += popcount32(whitespaceMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))));
+    for (std::size_t i = blocks; i < size; i++)
+        whitespace += isWhitespace(data[i]);
+
+    Writer writer(static_cast<uint32_t>(size) - whitespace);
+    for (std::size_t i = 0; i < blocks; i += 32) {
+        auto mask = whitespaceMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        if (mask == 0)
+            writer.putRun(data + i, 32);
+        else
+            writer.putMasked(data + i, 32, mask);
+    }
+    for (std::size_t i = blocks; i < size; i++) {
+        if (!isWhitespace(data[i]))
+            writer.put(data[i]);
+    }
+    return writer.finish();
+}
+#endif
+
+}  // namespace
+
+bool MurmurHash2KernelSupported(MurmurHash2Kernel kernel)
+{
+    switch (kernel) {
+        case MurmurHash2Kernel::Scalar:
+            return true;
+        case MurmurHash2Kernel::SSE2:
+#ifdef MURMUR2_HAVE_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case MurmurHash2Kernel::AVX2:
+#ifdef MURMUR2_HAVE_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+MurmurHash2Kernel MurmurHash2BestKernel()
+{
+    static const MurmurHash2Kernel best = [] {
+        for (auto kernel : { MurmurHash2Kernel::AVX2, MurmurHash2Kernel::SSE2 }) {
+            if (MurmurHash2KernelSupported(kernel))
+                return kernel;
+        }
+        return MurmurHash2Kernel::Scalar;
+    }();
+    return best;
+}
+
+uint32_t CurseForgeMurmurHash2(const char* data, std::size_t size)
+{
+    return CurseForgeMurmurHash2(data, size, MurmurHash2BestKernel());
+}
+
+uint32_t CurseForgeMurmurHash2(const char* data, std::size_t size, MurmurHash2Kernel kernel)
+{
+    auto bytes = reinterpret_cast<const unsigned char*>(data);
+    switch (kernel) {
+#ifdef MURMUR2_HAVE_AVX2
+        case MurmurHash2Kernel::AVX2:
+            if (MurmurHash2KernelSupported(kernel))
+                return avx2Kernel(bytes, size);
+            break;
+#endif
+#ifdef MURMUR2_HAVE_SSE2
+        case MurmurHash2Kernel::SSE2:
+            return sse2Kernel(bytes, size);
+#endif
+        default:
+            break;
+    }
+    return scalarKernel(bytes, size);
+}
+
+//-----------------------------------------------------------------------------
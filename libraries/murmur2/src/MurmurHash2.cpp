@@ -68,6 +68,39 @@ uint32_t MurmurHash2(std::ifstream&& file_stream, std::size_t buffer_size, std::
     return info.h;
 }
 
+uint32_t MurmurHash2(const char* data, std::size_t size, std::function<bool(char)> filter_out)
+{
+    uint32_t filtered_size = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        if (!filter_out(data[i]))
+            filtered_size += 1;
+    }
+
+    char block[4];
+    int index = 0;
+
+    // This forces a seed of 1.
+    IncrementalHashInfo info{ (uint32_t)1 ^ filtered_size, (uint32_t)filtered_size };
+    for (std::size_t i = 0; i < size; i++) {
+        char c = data[i];
+
+        if (filter_out(c))
+            continue;
+
+        block[index] = c;
+        index = (index + 1) % 4;
+
+        // Mix 4 bytes at a time into the hash
+        if (index == 0)
+            FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&block), info);
+    }
+
+    // Do one last bit shuffle in the hash
+    FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&block), info);
+
+    return info.h;
+}
+
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
 {
     if (prev.len >= 4) {
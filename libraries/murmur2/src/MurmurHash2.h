@@ -23,6 +23,23 @@ uint32_t MurmurHash2(
     std::size_t buffer_size = 4 * MiB,
     std::function<bool(char)> filter_out = [](char) { return false; });
 
+// Same as above, for data that is already in memory
+uint32_t MurmurHash2(
+    const char* data,
+    std::size_t size,
+    std::function<bool(char)> filter_out = [](char) { return false; });
+
+// The CurseForge fingerprint: MurmurHash2 with a seed of 1, skipping the whitespace bytes 9, 10, 13 and 32.
+// Gives the same result as the functions above with that filter, but classifies the bytes with SIMD where possible.
+enum class MurmurHash2Kernel { Scalar, SSE2, AVX2 };
+
+bool MurmurHash2KernelSupported(MurmurHash2Kernel kernel);
+// The widest kernel supported by the CPU we're running on
+MurmurHash2Kernel MurmurHash2BestKernel();
+
+uint32_t CurseForgeMurmurHash2(const char* data, std::size_t size);
+uint32_t CurseForgeMurmurHash2(const char* data, std::size_t size, MurmurHash2Kernel kernel);
+
 struct IncrementalHashInfo {
     uint32_t h;
     uint32_t len;
@@ -0,0 +1,150 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <FileSystem.h>
+#include <minecraft/AssetsUtils.h>
+
+class AssetsUtilsTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString objectsDir() const { return FS::PathCombine(m_dir.path(), "objects"); }
+
+    static QString sha1(const QByteArray& data) { return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex(); }
+
+    // Adds an object to the index, and to the objects folder if 'stored' isn't empty
+    void addObject(AssetsIndex& index, const QString& name, const QByteArray& data, const QByteArray& stored)
+    {
+        AssetObject object;
+        object.hash = sha1(data);
+        object.size = data.size();
+        index.objects.insert(name, object);
+        if (!stored.isEmpty())
+            FS::write(FS::PathCombine(objectsDir(), object.hash.left(2), object.hash), stored);
+    }
+
+    static QStringList hashes(const QList<AssetObject>& objects)
+    {
+        QStringList out;
+        for (auto& object : objects)
+            out.append(object.hash);
+        out.sort();
+        return out;
+    }
+
+   private slots:
+    void init()
+    {
+        QDir(m_dir.path()).removeRecursively();
+        QDir().mkpath(m_dir.path());
+    }
+
+    void test_loadIndex()
+    {
+        auto path = FS::PathCombine(m_dir.path(), "index.json");
+        QByteArray json = R"({
+            "virtual": true,
+            "objects": {
+                "icons/icon_16x16.png": { "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 3665 },
+                "a.ogg": { "hash": "0000000000000000000000000000000000000001", "size": 12 }
+            }
+        })";
+        FS::write(path, json);
+
+        AssetsIndex index;
+        QVERIFY(AssetsUtils::loadAssetsIndexJson("test", path, index));
+        QCOMPARE(index.id, QString("test"));
+        QCOMPARE(index.sha1, sha1(json));
+        QVERIFY(index.isVirtual);
+        QVERIFY(!index.mapToResources);
+        QCOMPARE(index.objects.size(), 2);
+        QCOMPARE(index.objects.value("icons/icon_16x16.png").hash, QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(index.objects.value("icons/icon_16x16.png").size, qint64(3665));
+        QCOMPARE(index.objects.firstKey(), QString("a.ogg"));
+    }
+
+    void test_missingObjects()
+    {
+        AssetsIndex index;
+        index.sha1 = "index";
+        addObject(index, "present", "present", "present");
+        addObject(index, "same object", "present", {});
+        addObject(index, "wrong size", "wrong size", "truncated");
+        addObject(index, "missing", "missing", {});
+
+        QStringList expected = { sha1("missing"), sha1("wrong size") };
+        expected.sort();
+        QCOMPARE(hashes(AssetsUtils::missingObjects(index, objectsDir())), expected);
+
+        // Nothing gets remembered while something is missing
+        QCOMPARE(hashes(AssetsUtils::missingObjects(index, objectsDir())), expected);
+    }
+
+    void test_verifiedCache()
+    {
+        AssetsIndex index;
+        index.sha1 = "index";
+        addObject(index, "a", "a", "a");
+        addObject(index, "b", "b", "b");
+        QVERIFY(AssetsUtils::missingObjects(index, objectsDir()).isEmpty());
+
+        // Corrupting an object in place doesn't touch its bucket, so the verified index is trusted as is
+        auto a = index.objects.value("a");
+        FS::write(FS::PathCombine(objectsDir(), a.hash.left(2), a.hash), "corrupted");
+        QVERIFY(AssetsUtils::missingObjects(index, objectsDir()).isEmpty());
+
+        // Removing one does, and that's noticed
+        QThread::msleep(20);
+        QVERIFY(QFile::remove(FS::PathCombine(objectsDir(), a.hash.left(2), a.hash)));
+        QCOMPARE(hashes(AssetsUtils::missingObjects(index, objectsDir())), QStringList{ a.hash });
+
+        // Once it's downloaded again, the index can be remembered as a whole
+        FS::write(FS::PathCombine(objectsDir(), a.hash.left(2), a.hash), "a");
+        AssetsUtils::markVerified(index, objectsDir());
+        QVERIFY(AssetsUtils::missingObjects(index, objectsDir()).isEmpty());
+    }
+
+    void test_reconstructVirtual()
+    {
+        auto previous = QDir::currentPath();
+        QDir::setCurrent(m_dir.path());
+
+        QByteArray json = R"({
+            "virtual": true,
+            "objects": {
+                "sounds/a.ogg": { "hash": "%1", "size": 1 },
+                "sounds/same.ogg": { "hash": "%1", "size": 1 },
+                "lang/b.lang": { "hash": "%2", "size": 1 }
+            }
+        })";
+        json.replace("%1", sha1("a").toLatin1()).replace("%2", sha1("b").toLatin1());
+        FS::write("assets/indexes/test.json", json);
+        FS::write(FS::PathCombine("assets/objects", sha1("a").left(2), sha1("a")), "a");
+        FS::write(FS::PathCombine("assets/objects", sha1("b").left(2), sha1("b")), "b");
+        FS::write("assets/virtual/test/old/stale.ogg", "stale");
+
+        QVERIFY(AssetsUtils::reconstructAssets("test", "resources"));
+
+        QCOMPARE(FS::read("assets/virtual/test/sounds/a.ogg"), QByteArray("a"));
+        QCOMPARE(FS::read("assets/virtual/test/sounds/same.ogg"), QByteArray("a"));
+        QCOMPARE(FS::read("assets/virtual/test/lang/b.lang"), QByteArray("b"));
+        QVERIFY(QFileInfo::exists("assets/virtual/test/.lastused"));
+        QVERIFY(!QFileInfo::exists("assets/virtual/test/old"));
+
+        // Present assets are left alone, and the marker survives
+        QVERIFY(AssetsUtils::reconstructAssets("test", "resources"));
+        QCOMPARE(FS::read("assets/virtual/test/sounds/a.ogg"), QByteArray("a"));
+        QVERIFY(QFileInfo::exists("assets/virtual/test/.lastused"));
+
+        QDir::setCurrent(previous);
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsUtilsTest)
+
+#include "AssetsUtils_test.moc"
@@ -0,0 +1,103 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <ContentStore.h>
+#include <FileSystem.h>
+
+class ContentStoreTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString path(const QString& name) const { return FS::PathCombine(m_dir.path(), name); }
+
+    static QString hash(const QByteArray& data, QCryptographicHash::Algorithm algorithm)
+    {
+        return QCryptographicHash::hash(data, algorithm).toHex();
+    }
+
+    // Stores a mod downloaded into the first instance, which fails where files can't be reflinked
+    bool storeMod(ContentStore& store, const QByteArray& data)
+    {
+        FS::write(path("first/mods/mod.jar"), data);
+        return store.add(path("first/mods/mod.jar"), "sha1", hash(data, QCryptographicHash::Sha1));
+    }
+
+   private slots:
+    void init()
+    {
+        QDir(m_dir.path()).removeRecursively();
+        QDir().mkpath(m_dir.path());
+    }
+
+    void test_addAndMaterialize()
+    {
+        ContentStore store(path("store"));
+        QByteArray data = "some mod";
+        if (!storeMod(store, data))
+            QSKIP("The temporary folder can't be used for cloning");
+
+        auto sha1 = hash(data, QCryptographicHash::Sha1);
+        auto sha512 = hash(data, QCryptographicHash::Sha512);
+        QVERIFY(!store.find("sha1", sha1).isEmpty());
+        QCOMPARE(store.find("sha512", sha512), store.find("sha1", sha1));
+        QVERIFY(store.find("md5", hash(data, QCryptographicHash::Md5)).isEmpty());
+
+        QVERIFY(store.materialize("sha512", sha512.toUpper(), path("second/mods/mod.jar")));
+        QCOMPARE(FS::read(path("second/mods/mod.jar")), data);
+
+        // Nothing is ever placed over an existing file
+        QVERIFY(!store.materialize("sha1", sha1, path("second/mods/mod.jar")));
+    }
+
+    void test_rejectsWrongHash()
+    {
+        ContentStore store(path("store"));
+        FS::write(path("first/mods/mod.jar"), "tampered");
+        QVERIFY(!store.add(path("first/mods/mod.jar"), "sha1", hash("original", QCryptographicHash::Sha1)));
+        QVERIFY(!store.add(path("first/mods/mod.jar"), "murmur2", "1234"));
+        QVERIFY(store.find("sha1", hash("tampered", QCryptographicHash::Sha1)).isEmpty());
+    }
+
+    void test_dropsDamagedObject()
+    {
+        ContentStore store(path("store"));
+        auto sha1 = hash("some mod", QCryptographicHash::Sha1);
+        auto object = path("store/objects/" + sha1.left(2) + "/" + sha1);
+        FS::write(object, "changed since");
+
+        QVERIFY(!store.materialize("sha1", sha1, path("second/mods/mod.jar")));
+        QVERIFY(!QFileInfo::exists(path("second/mods/mod.jar")));
+        QVERIFY(!QFileInfo::exists(object));
+        QVERIFY(store.find("sha1", sha1).isEmpty());
+    }
+
+    void test_collectGarbage()
+    {
+        ContentStore store(path("store"));
+        QByteArray data = "some mod";
+        if (!storeMod(store, data))
+            QSKIP("The temporary folder can't be used for cloning");
+        auto sha1 = hash(data, QCryptographicHash::Sha1);
+        QVERIFY(store.materialize("sha1", sha1, path("second/mods/mod.jar")));
+
+        // Still used by the second instance
+        QVERIFY(QFile::remove(path("first/mods/mod.jar")));
+        QCOMPARE(store.collectGarbage().objects, 0);
+        QVERIFY(!store.find("sha1", sha1).isEmpty());
+
+        QVERIFY(QFile::remove(path("second/mods/mod.jar")));
+        auto stats = store.collectGarbage();
+        QCOMPARE(stats.objects, 1);
+        QCOMPARE(stats.bytes, qint64(data.size()));
+        QVERIFY(store.find("sha1", sha1).isEmpty());
+        QVERIFY(store.find("sha512", hash(data, QCryptographicHash::Sha512)).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(ContentStoreTest)
+
+#include "ContentStore_test.moc"
@@ -0,0 +1,265 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QNetworkProxy>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <net/ChecksumValidator.h>
+#include <net/Download.h>
+#include <net/NetJob.h>
+
+#include <memory>
+
+/* Serves a single file, and answers Range requests when If-Range still matches it.
+ * The first responses can be cut short, like a flaky connection would. Only used for testing. */
+class RangeHttpServer : public QTcpServer {
+    Q_OBJECT
+
+   public:
+    explicit RangeHttpServer(QByteArray contents) : contents(contents)
+    {
+        connect(this, &QTcpServer::newConnection, this, &RangeHttpServer::acceptConnections);
+        listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/file").arg(serverPort())); }
+
+    QByteArray contents;
+    QByteArray etag = "\"v1\"";
+    // how many responses are cut short, and after how many bytes
+    int cuts = 0;
+    qint64 cutAfter = 0;
+
+    // the Range header of each request, empty when there was none
+    QList<QByteArray> ranges;
+    qint64 bytesSent = 0;
+
+   private:
+    void acceptConnections()
+    {
+        while (auto socket = nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket, buffer] {
+                buffer->append(socket->readAll());
+                int end;
+                while ((end = buffer->indexOf("\r\n\r\n")) != -1) {
+                    auto head = buffer->left(end);
+                    buffer->remove(0, end + 4);
+                    serve(socket, head);
+                }
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    void serve(QTcpSocket* socket, const QByteArray& head)
+    {
+        QHash<QByteArray, QByteArray> headers;
+        for (auto& line : head.split('\n').mid(1)) {
+            auto colon = line.indexOf(':');
+            headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+        }
+        ranges.append(headers.value("range"));
+
+        qint64 start = 0;
+        auto range = headers.value("range");
+        if (range.startsWith("bytes=") && (!headers.contains("if-range") || headers.value("if-range") == etag))
+            start = range.mid(6, range.indexOf('-') - 6).toLongLong();
+
+        auto body = contents.mid(start);
+        QByteArray response = start > 0 ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+        if (!etag.isEmpty())
+            response += "ETag: " + etag + "\r\n";
+        if (start > 0) {
+            response += "Content-Range: bytes " + QByteArray::number(start) + "-" + QByteArray::number(contents.size() - 1) + "/" +
+                        QByteArray::number(contents.size()) + "\r\n";
+        }
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+
+        if (cuts > 0) {
+            cuts--;
+            body.truncate(cutAfter);
+            socket->write(response + body);
+            socket->disconnectFromHost();
+        } else {
+            socket->write(response + body);
+        }
+        bytesSent += body.size();
+    }
+};
+
+class FileSinkTest : public QObject {
+    Q_OBJECT
+
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+
+    static QByteArray makeContents(int size, char seed)
+    {
+        QByteArray contents(size, Qt::Uninitialized);
+        for (int i = 0; i < size; i++)
+            contents[i] = static_cast<char>(seed + i * 7 + i / 251);
+        return contents;
+    }
+
+    // the first byte asked for by "Range: bytes=<first>-", -1 without one
+    static qint64 resumedFrom(const QByteArray& range)
+    {
+        if (!range.startsWith("bytes=") || !range.endsWith('-'))
+            return -1;
+        return range.mid(6, range.size() - 7).toLongLong();
+    }
+
+    bool download(const QUrl& url, const QString& path, const QByteArray& expected_sha1)
+    {
+        auto job = makeShared<NetJob>("FileSink", m_network);
+        auto dl = Net::Download::makeFile(url, path);
+        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, expected_sha1));
+        job->addNetAction(dl);
+
+        QSignalSpy finished(job.get(), &Task::finished);
+        job->start();
+        return finished.wait(30000) && job->wasSuccessful();
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        m_network.reset(new QNetworkAccessManager());
+        // the requests never leave this machine, even when there's a proxy configured for the tests
+        m_network->setProxy(QNetworkProxy::NoProxy);
+    }
+
+    void test_resumesAfterFailure()
+    {
+        auto contents = makeContents(512 * 1024, 1);
+        RangeHttpServer server(contents);
+        QVERIFY(server.isListening());
+        server.cuts = 1;
+        server.cutAfter = 200 * 1024;
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "file.bin");
+        QVERIFY(download(server.url(), path, QCryptographicHash::hash(contents, QCryptographicHash::Sha1)));
+
+        QCOMPARE(FS::read(path), contents);
+        QCOMPARE(server.ranges.size(), 2);
+        QVERIFY(server.ranges[0].isEmpty());
+        // whatever came in before the connection broke isn't asked for again
+        auto resumed = resumedFrom(server.ranges[1]);
+        QVERIFY(resumed > 0 && resumed <= server.cutAfter);
+        QCOMPARE(server.bytesSent, server.cutAfter + contents.size() - resumed);
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files), QStringList({ "file.bin" }));
+    }
+
+    void test_restartsWhenFileChanged()
+    {
+        auto old_contents = makeContents(256 * 1024, 1);
+        auto new_contents = makeContents(300 * 1024, 2);
+        RangeHttpServer server(old_contents);
+        server.cuts = 1;
+        server.cutAfter = 100 * 1024;
+
+        // the file changes right after the first attempt was cut short
+        connect(&server, &QTcpServer::newConnection, this, [&server, new_contents] {
+            if (server.ranges.size() == 1) {
+                server.contents = new_contents;
+                server.etag = "\"v2\"";
+            }
+        });
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "file.bin");
+        QVERIFY(download(server.url(), path, QCryptographicHash::hash(new_contents, QCryptographicHash::Sha1)));
+
+        QCOMPARE(FS::read(path), new_contents);
+        QCOMPARE(server.ranges.size(), 2);
+        QVERIFY(resumedFrom(server.ranges[1]) > 0);
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files), QStringList({ "file.bin" }));
+    }
+
+    void test_removesStalePartials()
+    {
+        auto contents = makeContents(16 * 1024, 5);
+        RangeHttpServer server(contents);
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "file.bin");
+        auto partial = [&dir](const QString& name, qint64 age_secs) {
+            auto file_path = FS::PathCombine(dir.path(), name);
+            FS::write(file_path, "leftover");
+            QFile file(file_path);
+            return file.open(QIODevice::ReadWrite) &&
+                   file.setFileTime(QDateTime::currentDateTime().addSecs(-age_secs), QFileDevice::FileModificationTime);
+        };
+        // left by a crash, still being written by another download, and belonging to another file
+        QVERIFY(partial("file.bin.1a2b.part", 24 * 60 * 60));
+        QVERIFY(partial("file.bin.3c4d.part", 0));
+        QVERIFY(partial("other.bin.5e6f.part", 24 * 60 * 60));
+
+        QVERIFY(download(server.url(), path, QCryptographicHash::hash(contents, QCryptographicHash::Sha1)));
+
+        QCOMPARE(FS::read(path), contents);
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files), QStringList({ "file.bin", "file.bin.3c4d.part", "other.bin.5e6f.part" }));
+    }
+
+    void test_noValidatorNoResume()
+    {
+        auto contents = makeContents(128 * 1024, 3);
+        RangeHttpServer server(contents);
+        server.etag.clear();
+        server.cuts = 1;
+        server.cutAfter = 64 * 1024;
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "file.bin");
+        QVERIFY(download(server.url(), path, QCryptographicHash::hash(contents, QCryptographicHash::Sha1)));
+
+        // without an ETag or a modification date, there's no telling whether the rest would fit, so it starts over
+        QCOMPARE(FS::read(path), contents);
+        QCOMPARE(server.ranges.size(), 2);
+        QVERIFY(server.ranges[1].isEmpty());
+    }
+
+    void test_checksumResume()
+    {
+        auto contents = makeContents(100 * 1024, 4);
+        auto expected = QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+        QNetworkRequest request;
+
+        QBuffer prefix;
+        prefix.setData(contents.left(40 * 1024));
+        QVERIFY(prefix.open(QIODevice::ReadOnly));
+        auto rest = contents.mid(40 * 1024);
+
+        // a new validator reads the prefix again
+        Net::ChecksumValidator fresh(QCryptographicHash::Sha1, expected);
+        QVERIFY(fresh.resume(request, prefix, prefix.size()));
+        QVERIFY(fresh.write(rest));
+        QCOMPARE(fresh.hash(), expected);
+
+        // the one that hashed the prefix already carries on from there
+        Net::ChecksumValidator continued(QCryptographicHash::Sha1, expected);
+        QVERIFY(continued.init(request));
+        auto head = prefix.data();
+        QVERIFY(continued.write(head));
+        QBuffer unreadable;
+        QVERIFY(continued.resume(request, unreadable, head.size()));
+        QVERIFY(continued.write(rest));
+        QCOMPARE(continued.hash(), expected);
+
+        // a prefix that can't be read in full fails
+        Net::ChecksumValidator truncated(QCryptographicHash::Sha1, expected);
+        QVERIFY(prefix.seek(0));
+        QVERIFY(!truncated.resume(request, prefix, contents.size()));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileSinkTest)
+
+#include "FileSink_test.moc"
@@ -353,6 +353,27 @@ class FileSystemTest : public QObject {
         }
     }
 
+    void test_filePlacerWithoutHardLinks()
+    {
+        QTemporaryDir tempDir;
+        auto src = FS::PathCombine(tempDir.path(), "objects", "object");
+        auto dst = FS::PathCombine(tempDir.path(), "resources", "sound.ogg");
+        FS::write(src, "shared object");
+        QVERIFY(FS::ensureFolderPathExists(QFileInfo(dst).path()));
+
+        FS::FilePlacer placer(QFileInfo(src).path(), QFileInfo(dst).path(), false);
+        QVERIFY(placer.method() != FS::FilePlacer::HardLink);
+        QVERIFY(placer.place(src, dst));
+        QCOMPARE(placer.linked.load(), 0);
+
+        // writing to what was placed, in place, leaves the source alone
+        QFile placed(dst);
+        QVERIFY(placed.open(QIODevice::ReadWrite));
+        QVERIFY(placed.write("changed") == 7);
+        placed.close();
+        QCOMPARE(FS::read(src), QByteArray("shared object"));
+    }
+
     void test_getDesktop() { QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation)); }
 
     void test_link()
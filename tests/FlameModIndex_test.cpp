@@ -0,0 +1,57 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <Json.h>
+
+#include <modplatform/flame/FlameModIndex.h>
+
+class FlameModIndexTest : public QObject {
+    Q_OBJECT
+
+    // A recorded response of https://api.curseforge.com/v1/mods/238222/files
+    static QJsonArray recordedFiles()
+    {
+        QString source = QFINDTESTDATA("testdata/FlameModIndex/files.json");
+        auto doc = QJsonDocument::fromJson(FS::read(source));
+        return Json::requireArray(doc.object(), "data");
+    }
+
+   private slots:
+    void test_latestVersion_anyLoader()
+    {
+        auto files = recordedFiles();
+        auto latest = FlameMod::loadLatestVersion(files, {});
+
+        // The newest entry is malformed, so it's skipped instead of failing the whole list
+        QCOMPARE(latest.fileId.toInt(), 4000002);
+        QCOMPARE(latest.addonId.toInt(), 238222);
+        QCOMPARE(latest.fileName, QString("jei-1.20.1-fabric-15.2.0.27.jar"));
+    }
+
+    void test_latestVersion_filtersLoaders()
+    {
+        auto files = recordedFiles();
+        auto latest = FlameMod::loadLatestVersion(files, ModPlatform::ModLoaderTypes(ModPlatform::Forge));
+
+        QCOMPARE(latest.fileId.toInt(), 4000001);
+        QCOMPARE(latest.version, QString("jei-1.20.1-forge-15.2.0.27"));
+        QCOMPARE(latest.hash, QString("5b4e1c5e0a2c7d6f1b2a3c4d5e6f708192a3b4c5"));
+        QVERIFY(!latest.downloadUrl.isEmpty());
+    }
+
+    void test_latestVersion_noMatch()
+    {
+        auto files = recordedFiles();
+        auto latest = FlameMod::loadLatestVersion(files, ModPlatform::ModLoaderTypes(ModPlatform::Quilt));
+        QVERIFY(!latest.addonId.isValid());
+
+        QJsonArray empty;
+        QVERIFY(!FlameMod::loadLatestVersion(empty, {}).addonId.isValid());
+    }
+};
+
+QTEST_GUILESS_MAIN(FlameModIndexTest)
+
+#include "FlameModIndex_test.moc"
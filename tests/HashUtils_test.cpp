@@ -0,0 +1,171 @@
+#include <QCryptographicHash>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <MurmurHash2.h>
+
+#include <FileSystem.h>
+#include <StringUtils.h>
+#include <modplatform/helpers/HashUtils.h>
+
+using Hashing::Algorithm;
+
+class HashUtilsTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString writeFile(const QString& name, const QByteArray& contents)
+    {
+        auto path = FS::PathCombine(m_dir.path(), name);
+        FS::write(path, contents);
+        return path;
+    }
+
+    static QString hex(const QByteArray& data, QCryptographicHash::Algorithm algorithm)
+    {
+        return QString::fromLatin1(QCryptographicHash::hash(data, algorithm).toHex());
+    }
+
+    static QString streamedMurmur2(const QString& path)
+    {
+        std::ifstream file_stream(StringUtils::toStdString(path).c_str(), std::ifstream::binary);
+        return QString::number(
+            MurmurHash2(std::move(file_stream), 4 * MiB, [](char c) { return c == 9 || c == 10 || c == 13 || c == 32; }));
+    }
+
+   private slots:
+    void test_hashFile_data()
+    {
+        QTest::addColumn<QByteArray>("contents");
+
+        QByteArray big;
+        for (int i = 0; i < 3 * 1024 * 1024 + 7; i++)
+            big.append(static_cast<char>((i * 31) % 251));
+
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("short") << QByteArray("abc");
+        QTest::newRow("whitespace") << QByteArray(" a\tb\r\nc d  \n");
+        QTest::newRow("only whitespace") << QByteArray(" \t\r\n");
+        QTest::newRow("multiple chunks") << big;
+    }
+    void test_hashFile()
+    {
+        QFETCH(QByteArray, contents);
+
+        auto path = writeFile(QTest::currentDataTag(), contents);
+        auto digests = Hashing::hashFile(path, Algorithm::Sha1 | Algorithm::Sha512 | Algorithm::Md5 | Algorithm::Murmur2);
+
+        QVERIFY(digests.isValid());
+        QCOMPARE(digests.sha1, hex(contents, QCryptographicHash::Sha1));
+        QCOMPARE(digests.sha512, hex(contents, QCryptographicHash::Sha512));
+        QCOMPARE(digests.md5, hex(contents, QCryptographicHash::Md5));
+        QCOMPARE(digests.murmur2, streamedMurmur2(path));
+    }
+
+    void test_onlyRequested()
+    {
+        auto path = writeFile("requested", "some data");
+        auto digests = Hashing::hashFile(path, Algorithm::Md5);
+
+        QVERIFY(!digests.md5.isEmpty());
+        QVERIFY(digests.sha1.isEmpty());
+        QVERIFY(digests.sha512.isEmpty());
+        QVERIFY(digests.murmur2.isEmpty());
+    }
+
+    void test_missingFile()
+    {
+        auto digests = Hashing::hashFile(FS::PathCombine(m_dir.path(), "does not exist"), Algorithm::Sha1);
+        QVERIFY(!digests.isValid());
+    }
+
+    void test_hashFilesAsync()
+    {
+        QStringList paths;
+        QList<QByteArray> contents;
+        for (int i = 0; i < 20; i++) {
+            contents.append(QByteArray(1000 + i * 4096, static_cast<char>('a' + i)));
+            paths.append(writeFile(QString("many-%1").arg(i), contents.last()));
+        }
+        paths.append(FS::PathCombine(m_dir.path(), "does not exist"));
+
+        auto future = Hashing::hashFilesAsync(paths, Algorithm::Sha1 | Algorithm::Sha512);
+        future.waitForFinished();
+
+        QCOMPARE(future.resultCount(), paths.size());
+        for (int i = 0; i < contents.size(); i++) {
+            auto digests = future.resultAt(i);
+            QCOMPARE(digests.sha1, hex(contents[i], QCryptographicHash::Sha1));
+            QCOMPARE(digests.sha512, hex(contents[i], QCryptographicHash::Sha512));
+        }
+        QVERIFY(!future.resultAt(contents.size()).isValid());
+    }
+
+    void test_Benchmark_data()
+    {
+        QTest::addColumn<bool>("parallel");
+
+        QTest::newRow("readAll, one by one") << false;
+        QTest::newRow("hashFilesAsync") << true;
+    }
+
+    // What the Modrinth pack export hashes: a few hundred mods, for both SHA1 and SHA512
+    void test_Benchmark()
+    {
+        QFETCH(bool, parallel);
+
+        QStringList paths;
+        for (int i = 0; i < 300; i++) {
+            QByteArray contents(64 * 1024 + (i * 7919) % (512 * 1024), Qt::Uninitialized);
+            for (int j = 0; j < contents.size(); j++)
+                contents[j] = static_cast<char>((j * 31 + i) % 251);
+            paths.append(writeFile(QString("mod-%1.jar").arg(i), contents));
+        }
+
+        QBENCHMARK
+        {
+            if (parallel) {
+                auto future = Hashing::hashFilesAsync(paths, Algorithm::Sha1 | Algorithm::Sha512);
+                future.waitForFinished();
+                QCOMPARE(future.resultCount(), paths.size());
+            } else {
+                // how the export used to do it
+                for (auto& path : paths) {
+                    QFile file(path);
+                    QVERIFY(file.open(QFile::ReadOnly));
+                    auto data = file.readAll();
+                    QCryptographicHash sha1(QCryptographicHash::Sha1);
+                    QCryptographicHash sha512(QCryptographicHash::Sha512);
+                    sha1.addData(data);
+                    sha512.addData(data);
+                    QVERIFY(!sha1.result().isEmpty() && !sha512.result().isEmpty());
+                }
+            }
+        }
+    }
+
+    void test_hasher()
+    {
+        QByteArray contents("hashed off the main thread");
+        auto path = writeFile("hasher", contents);
+
+        auto hasher = Hashing::createModrinthHasher(path);
+        QString result;
+        connect(hasher.get(), &Hashing::Hasher::resultsReady, this, [&result](QString hash) { result = hash; });
+
+        QEventLoop loop;
+        connect(hasher.get(), &Task::finished, &loop, &QEventLoop::quit);
+        hasher->start();
+        loop.exec();
+
+        QVERIFY(hasher->wasSuccessful());
+        QCOMPARE(result, hex(contents, QCryptographicHash::Sha512));
+    }
+};
+
+QTEST_GUILESS_MAIN(HashUtilsTest)
+
+#include "HashUtils_test.moc"
@@ -0,0 +1,200 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString indexPath() const { return FS::PathCombine(m_dir.path(), "metacache"); }
+
+    std::unique_ptr<HttpMetaCache> makeCache()
+    {
+        auto cache = std::make_unique<HttpMetaCache>(indexPath());
+        cache->addBase("general", FS::PathCombine(m_dir.path(), "general"));
+        cache->addBase("other", FS::PathCombine(m_dir.path(), "other"));
+        cache->Load();
+        return cache;
+    }
+
+    static void put(HttpMetaCache& cache, const QString& base, const QString& path, const QString& etag)
+    {
+        auto entry = cache.resolveEntry(base, path);
+        entry->setETag(etag);
+        entry->setMD5Sum("md5 of " + path);
+        entry->setLocalChangedTimestamp(1234);
+        entry->setRemoteChangedTimestamp("Thu, 01 Jan 1970 00:00:00 GMT");
+        entry->setCurrentAge(10);
+        entry->setMaximumAge(100);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+    }
+
+   private slots:
+    void init()
+    {
+        QDir(m_dir.path()).removeRecursively();
+        QDir().mkpath(m_dir.path());
+    }
+
+    void test_roundTrip()
+    {
+        {
+            auto cache = makeCache();
+            put(*cache, "general", "a.json", "etag a");
+            put(*cache, "other", "b.json", "etag b");
+        }
+
+        auto cache = makeCache();
+        auto entry = cache->getEntry("general", "a.json");
+        QVERIFY(entry);
+        QCOMPARE(entry->getETag(), QString("etag a"));
+        QCOMPARE(entry->getMD5Sum(), QString("md5 of a.json"));
+        QCOMPARE(entry->getRemoteChangedTimestamp(), QString("Thu, 01 Jan 1970 00:00:00 GMT"));
+        QCOMPARE(entry->getCurrentAge(), qint64(10));
+        QCOMPARE(entry->getMaximumAge(), qint64(100));
+        QVERIFY(!entry->isStale());
+
+        QVERIFY(cache->getEntry("other", "b.json"));
+        QVERIFY(!cache->getEntry("general", "b.json"));
+    }
+
+    void test_journal()
+    {
+        {
+            auto cache = makeCache();
+            put(*cache, "general", "a.json", "first");
+        }
+        auto journal = FS::PathCombine(indexPath() + ".d", "general.journal");
+        auto size = QFileInfo(journal).size();
+        QVERIFY(size > 0);
+
+        {
+            auto cache = makeCache();
+            put(*cache, "general", "a.json", "second");
+            put(*cache, "general", "c.json", "third");
+            QVERIFY(cache->evictEntry(cache->getEntry("general", "c.json")));
+        }
+        // only the changes got appended, and the last state of each entry wins
+        QVERIFY(QFileInfo(journal).size() > size);
+
+        auto cache = makeCache();
+        QCOMPARE(cache->getEntry("general", "a.json")->getETag(), QString("second"));
+        QVERIFY(!cache->getEntry("general", "c.json"));
+    }
+
+    void test_compaction()
+    {
+        auto base = FS::PathCombine(indexPath() + ".d", "general");
+        {
+            auto cache = makeCache();
+            for (int round = 0; round < 100; round++) {
+                for (int i = 0; i < 10; i++)
+                    put(*cache, "general", QString("%1.json").arg(i), QString::number(round * 10 + i));
+                cache->SaveNow();
+            }
+            // the journal got folded into the snapshot along the way
+            QVERIFY(QFileInfo(base + ".index").size() > 0);
+            QVERIFY(QFileInfo(base + ".journal").size() < 10 * 100 * 20);
+        }
+
+        auto cache = makeCache();
+        for (int i = 0; i < 10; i++)
+            QCOMPARE(cache->getEntry("general", QString("%1.json").arg(i))->getETag(), QString::number(990 + i));
+    }
+
+    void test_truncatedJournal()
+    {
+        {
+            auto cache = makeCache();
+            put(*cache, "general", "a.json", "a");
+            cache->SaveNow();
+            put(*cache, "general", "b.json", "b");
+        }
+        auto journal = FS::PathCombine(indexPath() + ".d", "general.journal");
+        QFile file(journal);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 3));
+        file.close();
+
+        {
+            auto cache = makeCache();
+            QVERIFY(cache->getEntry("general", "a.json"));
+            QVERIFY(!cache->getEntry("general", "b.json"));
+            put(*cache, "general", "c.json", "c");
+        }
+
+        auto cache = makeCache();
+        QVERIFY(cache->getEntry("general", "a.json"));
+        QVERIFY(cache->getEntry("general", "c.json"));
+    }
+
+    void test_resolveLocalFile()
+    {
+        auto cache = makeCache();
+        auto base = FS::PathCombine(m_dir.path(), "general");
+        auto path = FS::PathCombine(base, "file.bin");
+        QByteArray contents("some cached contents");
+        FS::write(path, contents);
+
+        auto entry = cache->resolveEntry("general", "file.bin");
+        entry->setMD5Sum(QCryptographicHash::hash(contents, QCryptographicHash::Md5).toHex());
+        entry->setLocalFile(QFileInfo(path));
+        entry->setMaximumAge(1000000);
+        entry->setStale(false);
+        QVERIFY(cache->updateEntry(entry));
+
+        // unchanged
+        QVERIFY(!cache->resolveEntry("general", "file.bin")->isStale());
+
+        auto touch = [&path](qint64 offset) {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTimeUtc().addSecs(offset), QFileDevice::FileModificationTime));
+        };
+
+        // touched, but same contents
+        touch(-60);
+        QVERIFY(!cache->resolveEntry("general", "file.bin")->isStale());
+        QCOMPARE(cache->getEntry("general", "file.bin")->getMD5Sum(), entry->getMD5Sum());
+
+        // same size, other contents
+        FS::write(path, QByteArray("Some cached contents"));
+        touch(-30);
+        QVERIFY(cache->resolveEntry("general", "file.bin")->isStale());
+        QVERIFY(!cache->getEntry("general", "file.bin"));
+    }
+
+    void test_legacyIndex()
+    {
+        FS::write(indexPath(), R"({"version": "1", "entries": [
+            {"base": "general", "path": "legacy.json", "md5sum": "abc", "etag": "old", "last_changed_timestamp": 5, "eternal": true},
+            {"base": "unknown", "path": "gone.json", "md5sum": "abc", "etag": "old", "last_changed_timestamp": 5}
+        ]})");
+
+        {
+            auto cache = makeCache();
+            auto entry = cache->getEntry("general", "legacy.json");
+            QVERIFY(entry);
+            QCOMPARE(entry->getETag(), QString("old"));
+            QVERIFY(entry->isEternal());
+        }
+
+        // the legacy index is only read once
+        FS::write(indexPath(), "{}");
+        auto cache = makeCache();
+        QVERIFY(cache->getEntry("general", "legacy.json"));
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
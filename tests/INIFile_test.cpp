@@ -1,8 +1,13 @@
 #include <QTest>
 
 #include <settings/INIFile.h>
+#include <settings/INISettingsObject.h>
+#include <QDir>
+#include <QDateTime>
 #include <QList>
+#include <QRect>
 #include <QSettings>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QVariant>
 #include "FileSystem.h"
@@ -11,6 +16,21 @@
 
 class IniFileTest : public QObject {
     Q_OBJECT
+
+    // What a value reads back as, given the type it was written with: scalars come back as strings
+    static QVariant asRead(const QVariant& value, int type)
+    {
+        switch (type) {
+            case QMetaType::QStringList:
+            case QMetaType::QVariantList:
+                return value.toStringList();
+            case QMetaType::QByteArray:
+                return value.toByteArray();
+            default:
+                return value.toString();
+        }
+    }
+
    private slots:
     void initTestCase() {}
     void cleanupTestCase() {}
@@ -190,6 +210,277 @@ PreLaunchCommand=)";
         FS::deletePath(fileName);
 #endif
     }
+
+    void test_RoundTrip_data()
+    {
+        QTest::addColumn<QString>("key");
+        QTest::addColumn<QVariant>("value");
+
+        QTest::newRow("plain") << "name" << QVariant("Minecraft 1.20.1");
+        QTest::newRow("empty") << "empty" << QVariant("");
+        QTest::newRow("spaces") << "spaces" << QVariant("  padded  ");
+        QTest::newRow("quotes") << "quotes" << QVariant(R"("$INST_JAVA" -jar "a b.jar")");
+        QTest::newRow("separators") << "separators" << QVariant("a=b; c, d");
+        QTest::newRow("comment chars") << "comment" << QVariant("; not # a comment");
+        QTest::newRow("backslashes") << "backslashes" << QVariant("C:\\Program files\\\\x41\\");
+        QTest::newRow("control chars") << "control" << QVariant(QString("\x01" "abc\x1f" "1\a\b\f\n\r\t\v"));
+        QTest::newRow("null") << "null" << QVariant(QString("a") + QChar(0) + "0");
+        QTest::newRow("latin1") << "latin1" << QVariant(QString::fromUtf8("Crème brûlée"));
+        QTest::newRow("cjk") << "cjk" << QVariant(QString::fromUtf8("我的世界"));
+        QTest::newRow("at") << "at" << QVariant("@ByteArray(not really)");
+        QTest::newRow("double at") << "doubleAt" << QVariant("@@");
+        QTest::newRow("int") << "int" << QVariant(4096);
+        QTest::newRow("bool") << "bool" << QVariant(true);
+        QTest::newRow("double") << "double" << QVariant(0.1);
+        QTest::newRow("bytes") << "bytes" << QVariant(QByteArray("\x00\x01\xff geometry", 12));
+        QTest::newRow("string list") << "list" << QVariant(QStringList{ "a", " b ", "c,d", "@e", "" });
+        QTest::newRow("single item list") << "single" << QVariant(QStringList{ "only" });
+        QTest::newRow("empty list") << "emptyList" << QVariant(QStringList{});
+        QTest::newRow("int list") << "ints" << QVariantUtils::fromList(QList<int>{ 1, 2, 3, 10 });
+        QTest::newRow("odd key") << QString::fromUtf8("key with spaces=é") << QVariant("value");
+        QTest::newRow("grouped key") << "group/sub/key" << QVariant("value");
+        QTest::newRow("general group") << "General/key" << QVariant("value");
+    }
+
+    void test_RoundTrip()
+    {
+        QFETCH(QString, key);
+        QFETCH(QVariant, value);
+        const auto expected = asRead(value, value.userType());
+
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+
+        INIFile f;
+        f.set(key, value);
+        QVERIFY(f.saveFile(fileName));
+
+        INIFile f2;
+        QVERIFY(f2.loadFile(fileName));
+        QCOMPARE(asRead(f2.get(key, "NOT SET"), value.userType()), expected);
+        QCOMPARE(f2.get("ConfigVersion", "NOT SET").toString(), "1.2");
+
+        // what's written has to read the same with QSettings...
+        QSettings settings{ fileName, QSettings::Format::IniFormat };
+        settings.setFallbacksEnabled(false);
+        QCOMPARE(settings.status(), QSettings::Status::NoError);
+        QCOMPARE(asRead(settings.value(key), value.userType()), expected);
+
+        // ...and what QSettings writes has to read the same here
+        QString otherFileName = FS::PathCombine(dir.path(), "other.cfg");
+        {
+            QSettings other{ otherFileName, QSettings::Format::IniFormat };
+            other.setValue("ConfigVersion", "1.2");
+            other.setValue(key, value);
+        }
+        INIFile f3;
+        QVERIFY(f3.loadFile(otherFileName));
+        QCOMPARE(asRead(f3.get(key, "NOT SET"), value.userType()), expected);
+    }
+
+    void test_ReadsLikeQSettings_data()
+    {
+        QTest::addColumn<QByteArray>("content");
+
+        QTest::newRow("general section") << QByteArray("[General]\nConfigVersion=1.2\nname=a\n");
+        QTest::newRow("no section") << QByteArray("ConfigVersion=1.2\r\nname = spaced out \r\n");
+        QTest::newRow("comments") << QByteArray("; leading\nConfigVersion=1.2 ; trailing\nname=\"a;b\" ;c\n\n  ;indented\n");
+        QTest::newRow("groups") << QByteArray("ConfigVersion=1.2\n[group]\nkey=1\nsub\\key=2\n[%General]\nkey=3\n[%C3%A9]\nkey=4\n");
+        QTest::newRow("multiline quotes") << QByteArray("ConfigVersion=1.2\nname=\"first\nsecond\"\nother=x\n");
+        QTest::newRow("continuation") << QByteArray("ConfigVersion=1.2\nname=first\\\nsecond\n");
+        QTest::newRow("escapes") << QByteArray("ConfigVersion=1.2\nname=\\x41\\101\\q\\\"\\'\\?\\x\n");
+        QTest::newRow("lists") << QByteArray("ConfigVersion=1.2\nlist= a , \"b \", c\\,d ,\nmixed=@Invalid(), @@x\n");
+        QTest::newRow("bom") << QByteArray("\xef\xbb\xbf" "ConfigVersion=1.2\nname=\xc3\xa9\n");
+        QTest::newRow("special values") << QByteArray("ConfigVersion=1.2\na=@Invalid()\nb=@ByteArray(xyz)\nc=@String(s)\nd=@@e\n");
+        QTest::newRow("duplicates") << QByteArray("ConfigVersion=1.2\nname=first\nname=second\n");
+        QTest::newRow("malformed") << QByteArray("ConfigVersion=1.2\njust some text\n");
+        QTest::newRow("bad section") << QByteArray("ConfigVersion=1.2\n[unclosed\nname=a\n");
+    }
+
+    void test_ReadsLikeQSettings()
+    {
+        QFETCH(QByteArray, content);
+
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+        FS::write(fileName, content);
+
+        QSettings settings{ fileName, QSettings::Format::IniFormat };
+        settings.setFallbacksEnabled(false);
+        const auto keys = settings.allKeys();
+
+        INIFile f;
+        QCOMPARE(f.loadFile(fileName), settings.status() == QSettings::Status::NoError);
+        if (settings.status() != QSettings::Status::NoError)
+            return;
+
+        QCOMPARE(f.size(), keys.size());
+        for (auto key : keys) {
+            QVERIFY2(f.contains(key), qPrintable(key));
+            auto expected = settings.value(key);
+            QCOMPARE(asRead(f.get(key, "NOT SET"), expected.userType()), asRead(expected, expected.userType()));
+        }
+    }
+
+    void test_SaveLoadOtherTypes()
+    {
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+        const QRect rect(1, 2, 3, 4);
+        const auto time = QDateTime::fromString("2023-04-05T06:07:08Z", Qt::ISODate);
+
+        // only QSettings knows how to write these
+        INIFile f;
+        f.set("name", "other types");
+        f.set("rect", rect);
+        f.set("time", time);
+        QVERIFY(f.saveFile(fileName));
+
+        INIFile f2;
+        QVERIFY(f2.loadFile(fileName));
+        QCOMPARE(f2.get("name", "NOT SET").toString(), "other types");
+        QCOMPARE(f2.get("rect", QRect()).toRect(), rect);
+        QCOMPARE(f2.get("time", QDateTime()).toDateTime(), time);
+    }
+
+    void test_Benchmark_data()
+    {
+        QTest::addColumn<bool>("native");
+
+        QTest::newRow("INIFile") << true;
+        QTest::newRow("QSettings") << false;
+    }
+
+    void test_Benchmark()
+    {
+        QFETCH(bool, native);
+
+        QTemporaryDir dir;
+        QStringList files;
+        for (int i = 0; i < 1000; i++) {
+            INIFile f;
+            f.set("InstanceType", "OneSix");
+            f.set("name", QString("Instance %1").arg(i));
+            f.set("iconKey", "grass");
+            f.set("notes", "A long note, with \"quotes\"; separators = and\nline breaks");
+            f.set("JvmArgs", "-XX:+UseG1GC -XX:MaxGCPauseMillis=50 -Dfml.ignoreInvalidMinecraftCertificates=true");
+            f.set("PreLaunchCommand", "\"$INST_JAVA\" -jar packwiz-installer-bootstrap.jar https://example.com/pack.toml");
+            f.set("totalTimePlayed", 123456 + i);
+            f.set("lastLaunchTime", QVariant(qint64(1700000000000) + i));
+            f.set("OverrideMemory", true);
+            for (int j = 0; j < 32; j++)
+                f.set(QString("Setting%1").arg(j), QString("value %1/%2").arg(i).arg(j));
+            files.append(FS::PathCombine(dir.path(), QString("%1.cfg").arg(i)));
+            QVERIFY(f.saveFile(files.last()));
+        }
+
+        QBENCHMARK
+        {
+            for (auto& file : files) {
+                if (native) {
+                    INIFile f;
+                    f.loadFile(file);
+                    f.set("lastLaunchTime", f.get("lastLaunchTime", 0).toLongLong() + 1);
+                    f.saveFile(file);
+                } else {
+                    QSettings settings{ file, QSettings::Format::IniFormat };
+                    settings.setFallbacksEnabled(false);
+                    QMap<QString, QVariant> values;
+                    for (auto&& key : settings.allKeys())
+                        values.insert(key, settings.value(key));
+                    values["lastLaunchTime"] = values.value("lastLaunchTime").toLongLong() + 1;
+                    settings.clear();
+                    for (auto it = values.cbegin(); it != values.cend(); ++it)
+                        settings.setValue(it.key(), it.value());
+                    settings.sync();
+                }
+            }
+        }
+    }
+
+    void test_SettingsObjectSavesEventually()
+    {
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+
+        INISettingsObject settings(fileName);
+        settings.registerSetting("name", "Unnamed Instance");
+        settings.registerSetting("iconKey", "default");
+        settings.set("name", "first");
+        settings.set("name", "second");
+        settings.set("iconKey", "grass");
+
+        // nothing is written while the changes are being made
+        QVERIFY(!QFile::exists(fileName));
+
+        INIFile f;
+        QTRY_VERIFY(QFile::exists(fileName) && f.loadFile(fileName) && f.contains("iconKey"));
+        QCOMPARE(f.get("name", "NOT SET").toString(), "second");
+        QCOMPARE(f.get("iconKey", "NOT SET").toString(), "grass");
+    }
+
+    void test_SettingsObjectFlushes()
+    {
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+
+        {
+            INISettingsObject settings(fileName);
+            settings.registerSetting("name", "Unnamed Instance");
+            settings.set("name", "flushed");
+            settings.flush();
+
+            INIFile f;
+            QVERIFY(f.loadFile(fileName));
+            QCOMPARE(f.get("name", "NOT SET").toString(), "flushed");
+
+            settings.set("name", "destroyed");
+        }
+
+        INIFile f;
+        QVERIFY(f.loadFile(fileName));
+        QCOMPARE(f.get("name", "NOT SET").toString(), "destroyed");
+    }
+
+    void test_SettingsObjectFlushWaitsForBackgroundSave()
+    {
+        QTemporaryDir dir;
+        QString fileName = FS::PathCombine(dir.path(), "instance.cfg");
+
+        INISettingsObject settings(fileName);
+        settings.registerSetting("name", "Unnamed Instance");
+        settings.set("name", "in the background");
+
+        // around when the save timer runs out, so the write may have been started on another thread
+        QTest::qWait(1000);
+        settings.flush();
+
+        INIFile f;
+        QVERIFY(f.loadFile(fileName));
+        QCOMPARE(f.get("name", "NOT SET").toString(), "in the background");
+    }
+
+    void test_SettingsObjectDoesntRecreateFolders()
+    {
+        QTemporaryDir dir;
+        QString instanceDir = FS::PathCombine(dir.path(), "instance");
+        QVERIFY(QDir().mkpath(instanceDir));
+
+        INISettingsObject settings(FS::PathCombine(instanceDir, "instance.cfg"));
+        settings.registerSetting("name", "Unnamed Instance");
+        settings.set("name", "deleted");
+        QVERIFY(QDir(instanceDir).removeRecursively());
+
+        settings.flush();
+        QVERIFY(!QFileInfo::exists(instanceDir));
+
+        // what couldn't be written then still is once the folder is back
+        QVERIFY(QDir().mkpath(instanceDir));
+        settings.flush();
+        INIFile f;
+        QVERIFY(f.loadFile(FS::PathCombine(instanceDir, "instance.cfg")));
+        QCOMPARE(f.get("name", "NOT SET").toString(), "deleted");
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -0,0 +1,156 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTest>
+
+#include <launch/LogClassifier.h>
+
+// The per-line implementation LogClassifier replaced, kept as the reference for equivalence and speed
+static MessageLevel::Enum legacyGuessLevel(const QString& line, MessageLevel::Enum level)
+{
+    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+    auto match = re.match(line);
+    if (match.hasMatch()) {
+        QString levelStr = match.captured("level");
+        if (levelStr == "INFO")
+            level = MessageLevel::Message;
+        if (levelStr == "WARN")
+            level = MessageLevel::Warning;
+        if (levelStr == "ERROR")
+            level = MessageLevel::Error;
+        if (levelStr == "FATAL")
+            level = MessageLevel::Fatal;
+        if (levelStr == "TRACE" || levelStr == "DEBUG")
+            level = MessageLevel::Debug;
+    } else {
+        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
+            line.contains("[FINEST]"))
+            level = MessageLevel::Message;
+        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
+            level = MessageLevel::Error;
+        if (line.contains("[WARNING]"))
+            level = MessageLevel::Warning;
+        if (line.contains("[DEBUG]"))
+            level = MessageLevel::Debug;
+    }
+    if (line.contains("overwriting existing"))
+        return MessageLevel::Fatal;
+    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+    if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
+        line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
+        line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
+        line.contains(QRegularExpression("... \\d+ more$")))
+        return MessageLevel::Error;
+    return level;
+}
+
+static QStringList loadLog(const QString& name)
+{
+    QFile file(QFINDTESTDATA("testdata/LogClassifier/" + name));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromUtf8(file.readAll()).split('\n');
+}
+
+class LogClassifierTest : public QObject {
+    Q_OBJECT
+
+    static constexpr int benchmarkLines = 50000;
+
+    QStringList benchmarkLog()
+    {
+        auto log = loadLog("forge.log") + loadLog("fabric.log");
+        QStringList lines;
+        lines.reserve(benchmarkLines);
+        while (lines.size() < benchmarkLines) {
+            lines.append(log.at(lines.size() % log.size()));
+        }
+        return lines;
+    }
+
+   private slots:
+    void test_matchesLegacy_data()
+    {
+        QTest::addColumn<QString>("line");
+
+        for (auto name : { "forge.log", "fabric.log" }) {
+            auto lines = loadLog(name);
+            QVERIFY(!lines.isEmpty());
+            for (int i = 0; i < lines.size(); i++) {
+                QTest::newRow(QString("%1:%2").arg(name).arg(i + 1).toUtf8()) << lines[i];
+            }
+        }
+        QTest::newRow("log4j unknown level") << QString("[12:00:00] [main/NOTICE]: something [DEBUG] happened");
+        QTest::newRow("log4j after old tag") << QString("[WARNING] [12:00:00] [main/INFO]: mixed");
+        QTest::newRow("tags in reverse priority") << QString("[DEBUG] [WARNING] [SEVERE] [INFO]");
+        QTest::newRow("unterminated tag") << QString("[INFO");
+        QTest::newRow("more without frames") << QString("there is nothing more");
+        QTest::newRow("plain word at") << QString("look at this");
+        QTest::newRow("digit-only package") << QString("1.Error");
+    }
+    void test_matchesLegacy()
+    {
+        QFETCH(QString, line);
+
+        auto& classifier = LogClassifier::instance();
+        for (auto level : { MessageLevel::StdOut, MessageLevel::StdErr, MessageLevel::Unknown }) {
+            QCOMPARE(classifier.classify(line, level), legacyGuessLevel(line, level));
+        }
+    }
+
+    void test_batch()
+    {
+        auto lines = loadLog("forge.log");
+        QList<MessageLevel::Enum> levels;
+        for (int i = 0; i < lines.size(); i++) {
+            levels.append(i % 2 ? MessageLevel::Launcher : MessageLevel::StdOut);
+        }
+
+        LogClassifier::instance().classify(lines, levels);
+
+        for (int i = 0; i < lines.size(); i++) {
+            if (i % 2)
+                QCOMPARE(levels[i], MessageLevel::Launcher);
+            else
+                QCOMPARE(levels[i], legacyGuessLevel(lines[i], MessageLevel::StdOut));
+        }
+    }
+
+    void benchmark_classify_data()
+    {
+        QTest::addColumn<bool>("legacy");
+        QTest::newRow("legacy") << true;
+        QTest::newRow("classifier") << false;
+    }
+    void benchmark_classify()
+    {
+        QFETCH(bool, legacy);
+        auto lines = benchmarkLog();
+        auto classifyAll = [&lines, legacy] {
+            QList<MessageLevel::Enum> levels;
+            levels.reserve(lines.size());
+            for (int i = 0; i < lines.size(); i++)
+                levels.append(MessageLevel::StdOut);
+            if (legacy) {
+                for (int i = 0; i < lines.size(); i++)
+                    levels[i] = legacyGuessLevel(lines[i], levels[i]);
+            } else {
+                LogClassifier::instance().classify(lines, levels);
+            }
+            return levels;
+        };
+
+        QElapsedTimer timer;
+        timer.start();
+        classifyAll();
+        qDebug() << QTest::currentDataTag() << ":" << qRound64(lines.size() * 1e9 / qMax<qint64>(1, timer.nsecsElapsed())) << "lines/sec";
+
+        QBENCHMARK
+        {
+            classifyAll();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LogClassifierTest)
+
+#include "LogClassifier_test.moc"
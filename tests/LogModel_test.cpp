@@ -0,0 +1,87 @@
+#include <QTest>
+
+#include <launch/LogModel.h>
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+    static QStringList makeLines(int from, int count)
+    {
+        QStringList lines;
+        for (int i = from; i < from + count; i++) {
+            lines.append(QString("line %1").arg(i));
+        }
+        return lines;
+    }
+
+    static QList<MessageLevel::Enum> makeLevels(int count)
+    {
+        QList<MessageLevel::Enum> levels;
+        for (int i = 0; i < count; i++) {
+            levels.append(MessageLevel::Message);
+        }
+        return levels;
+    }
+
+   private slots:
+    void test_batchMatchesSingle_data()
+    {
+        QTest::addColumn<bool>("stopOnOverflow");
+        QTest::addColumn<QList<int>>("chunks");
+
+        QTest::newRow("fits") << false << QList<int>{ 3, 4 };
+        QTest::newRow("rotates") << false << QList<int>{ 7, 6, 2 };
+        QTest::newRow("chunk larger than buffer") << false << QList<int>{ 4, 25, 3 };
+        QTest::newRow("stop exactly full") << true << QList<int>{ 5, 5 };
+        QTest::newRow("stop overflow in chunk") << true << QList<int>{ 8, 6, 4 };
+    }
+    void test_batchMatchesSingle()
+    {
+        QFETCH(bool, stopOnOverflow);
+        QFETCH(QList<int>, chunks);
+
+        LogModel single;
+        LogModel batched;
+        for (auto model : { &single, &batched }) {
+            model->setMaxLines(10);
+            model->setStopOnOverflow(stopOnOverflow);
+            model->setOverflowMessage("OVERFLOW");
+        }
+
+        int next = 0;
+        for (auto size : chunks) {
+            auto lines = makeLines(next, size);
+            next += size;
+            for (auto& line : lines) {
+                single.append(MessageLevel::Message, line);
+            }
+            batched.append(makeLevels(size), lines);
+            QCOMPARE(batched.rowCount(), single.rowCount());
+            QCOMPARE(batched.toPlainText(), single.toPlainText());
+        }
+    }
+
+    void test_flushInterval()
+    {
+        LogModel model;
+        model.setFlushInterval(1000);
+        model.append(makeLevels(3), makeLines(0, 3));
+        QCOMPARE(model.rowCount(), 0);
+
+        // single lines queue up behind pending chunks
+        model.append(MessageLevel::Launcher, "launcher line");
+        QCOMPARE(model.rowCount(), 0);
+
+        model.flush();
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(model.data(model.index(3), Qt::DisplayRole).toString(), QString("launcher line"));
+
+        model.setFlushInterval(10);
+        model.append(makeLevels(2), makeLines(3, 2));
+        QTRY_COMPARE(model.rowCount(), 6);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
@@ -0,0 +1,331 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+
+#include <quazip/quazipfile.h>
+
+#include <utility>
+
+using Entries = QList<std::pair<QString, QByteArray>>;
+
+class MMCZipTest : public QObject {
+    Q_OBJECT
+
+    static bool writeZip(const QString& path, const Entries& entries, int method = Z_DEFLATED)
+    {
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdCreate))
+            return false;
+        for (auto& entry : entries) {
+            QuaZipFile file(&zip);
+            QuaZipNewInfo info(entry.first);
+            info.dateTime = QDateTime(QDate(2010, 5, 17), QTime(12, 0));
+            if (!file.open(QIODevice::WriteOnly, info, nullptr, 0, method) || file.write(entry.second) != entry.second.size())
+                return false;
+            file.close();
+        }
+        zip.close();
+        return zip.getZipError() == 0;
+    }
+
+    // the contents of every entry, checked against their CRC
+    static QMap<QString, QByteArray> readZip(const QString& path)
+    {
+        QMap<QString, QByteArray> contents;
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdUnzip))
+            return contents;
+        QuaZipFile file(&zip);
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            if (!file.open(QIODevice::ReadOnly))
+                return {};
+            auto data = file.readAll();
+            file.close();
+            if (file.getZipError() != 0)
+                return {};
+            contents.insert(zip.getCurrentFileName(), data);
+        }
+        return contents;
+    }
+
+    // A jar like the vanilla one: thousands of small, fairly compressible classes
+    static Entries syntheticJar(int count)
+    {
+        Entries entries;
+        for (int i = 0; i < count; i++) {
+            QByteArray data;
+            data += QByteArray::fromHex("cafebabe00000034");
+            for (int j = 0; j < 40 + i % 60; j++)
+                data += QString("net/minecraft/class_%1;method_%2(Lnet/minecraft/class_%3;)V").arg(i).arg(j).arg(j * 31 % 977).toUtf8();
+            entries.append({ QString("net/minecraft/class_%1.class").arg(i), data });
+        }
+        entries.append({ "META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n" });
+        return entries;
+    }
+
+    // how every entry was copied before: inflated, then deflated again
+    static bool recompressZipFiles(QuaZip* into, const QString& from)
+    {
+        QuaZip zip(from);
+        zip.open(QuaZip::mdUnzip);
+        QuaZipFile in(&zip);
+        QuaZipFile out(into);
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly, QuaZipNewInfo(in.getActualFileName())))
+                return false;
+            bool copied = JlCompress::copyData(in, out);
+            out.close();
+            in.close();
+            if (!copied)
+                return false;
+        }
+        return true;
+    }
+
+   private slots:
+    void test_mergeZipFiles()
+    {
+        QTemporaryDir dir;
+        auto mod = FS::PathCombine(dir.path(), "mod.zip");
+        auto stored = FS::PathCombine(dir.path(), "stored.zip");
+        auto vanilla = FS::PathCombine(dir.path(), "vanilla.jar");
+        QVERIFY(writeZip(mod, { { "a.class", "modded a" }, { "META-INF/MANIFEST.MF", "mod manifest" } }));
+        QVERIFY(writeZip(stored, { { "assets/pack.png", QByteArray(3000, 'p') }, { "a.class", "other modded a" } }, 0));
+        QVERIFY(writeZip(vanilla, { { "a.class", "vanilla a" },
+                                    { "b.class", QByteArray(10000, 'b') },
+                                    { "META-INF/MOJANGCS.SF", "signature" },
+                                    { "empty/", "" } }));
+
+        auto out = FS::PathCombine(dir.path(), "minecraft.jar");
+        {
+            QuaZip zipOut(out);
+            QVERIFY(zipOut.open(QuaZip::mdCreate));
+            // the same order createModdedJar uses: the mods first, then what's left of the vanilla jar
+            QSet<QString> contained;
+            QVERIFY(MMCZip::mergeZipFiles(&zipOut, QFileInfo(mod), contained));
+            QVERIFY(MMCZip::mergeZipFiles(&zipOut, QFileInfo(stored), contained));
+            QVERIFY(MMCZip::mergeZipFiles(&zipOut, QFileInfo(vanilla), contained,
+                                          [](const QString& key) { return !key.contains("META-INF"); }));
+            zipOut.close();
+            QCOMPARE(zipOut.getZipError(), 0);
+        }
+
+        auto contents = readZip(out);
+        QCOMPARE(contents.keys(), QStringList({ "META-INF/MANIFEST.MF", "a.class", "assets/pack.png", "b.class", "empty/" }));
+        QCOMPARE(contents["a.class"], QByteArray("modded a"));
+        QCOMPARE(contents["META-INF/MANIFEST.MF"], QByteArray("mod manifest"));
+        QCOMPARE(contents["assets/pack.png"], QByteArray(3000, 'p'));
+        QCOMPARE(contents["b.class"], QByteArray(10000, 'b'));
+
+        // the entries are copied as they were, down to how they're compressed
+        QuaZip zip(out);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QuaZipFileInfo64 info;
+        QVERIFY(zip.setCurrentFile("assets/pack.png"));
+        QVERIFY(zip.getCurrentFileInfo(&info));
+        QCOMPARE(int(info.method), 0);
+        QVERIFY(zip.setCurrentFile("b.class"));
+        QVERIFY(zip.getCurrentFileInfo(&info));
+        QCOMPARE(int(info.method), Z_DEFLATED);
+        QVERIFY(info.compressedSize < 10000);
+        QCOMPARE(info.dateTime, QDateTime(QDate(2010, 5, 17), QTime(12, 0)));
+    }
+
+    void test_findFolderOfFileInZip()
+    {
+        QStringList names{ "overrides/manifest.json", "pack/overrides/", "pack/sub/manifest.json", "pack/manifest.json",
+                           "other/manifest.json",     "instance.cfg.bak" };
+        QStringList ignore{ "overrides/" };
+
+        QCOMPARE(MMCZip::findFolderOfFileInZip(names, "manifest.json", ignore), QString("pack/"));
+        QCOMPARE(MMCZip::findFolderOfFileInZip(names, "manifest.json"), QString("overrides/"));
+        QVERIFY(MMCZip::findFolderOfFileInZip(names, "instance.cfg").isNull());
+
+        auto root = MMCZip::findFolderOfFileInZip(QStringList{ "pack/instance.cfg", "instance.cfg" }, "instance.cfg");
+        QVERIFY(!root.isNull());
+        QVERIFY(root.isEmpty());
+    }
+
+    void test_extractZip()
+    {
+        QTemporaryDir dir;
+        auto archive = FS::PathCombine(dir.path(), "pack.zip");
+        Entries entries{ { "manifest.json", "not extracted" },
+                         { "pack/", "" },
+                         { "pack/manifest.json", "{}" },
+                         { "pack/overrides/empty/", "" },
+                         { "pack/overrides/options.txt", "" },
+                         { "pack/overrides/mods/big.jar", QByteArray(3 * 1024 * 1024 + 17, 'b') } };
+        for (int i = 0; i < 300; i++)
+            entries.append({ QString("pack/overrides/config/%1.toml").arg(i), QByteArray(100 + i, static_cast<char>(i)) });
+        QVERIFY(writeZip(archive, entries));
+
+        auto target = FS::PathCombine(dir.path(), "instance");
+        auto task = makeShared<MMCZip::ExtractZipTask>(archive, QDir(target), "pack/");
+        task->setMaxThreads(4);
+        QSignalSpy finished(task.get(), &Task::finished);
+        task->start();
+        QVERIFY(finished.wait(60000));
+        QVERIFY(task->wasSuccessful());
+
+        qint64 total = 0;
+        for (auto& entry : entries) {
+            if (!entry.first.startsWith("pack/") || entry.first.endsWith('/'))
+                continue;
+            QCOMPARE(FS::read(FS::PathCombine(target, entry.first.mid(5))), entry.second);
+            total += entry.second.size();
+        }
+        QVERIFY(QDir(FS::PathCombine(target, "overrides/empty")).exists());
+        QVERIFY(!QFile::exists(FS::PathCombine(dir.path(), "manifest.json")));
+        // the progress is in bytes
+        QCOMPARE(task->getProgress(), total);
+        QCOMPARE(task->getTotalProgress(), total);
+    }
+
+    void test_extractZip_outsideTarget()
+    {
+        QTemporaryDir dir;
+        auto archive = FS::PathCombine(dir.path(), "pack.zip");
+        QVERIFY(writeZip(archive, { { "pack/manifest.json", "{}" }, { "pack/../evil.txt", "evil" } }));
+
+        auto target = FS::PathCombine(dir.path(), "instance");
+        auto task = makeShared<MMCZip::ExtractZipTask>(archive, QDir(target), "pack/");
+        QSignalSpy finished(task.get(), &Task::finished);
+        task->start();
+        QVERIFY(finished.wait(60000));
+        QVERIFY(!task->wasSuccessful());
+
+        // nothing is written at all
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "manifest.json")));
+        QVERIFY(!QFile::exists(FS::PathCombine(dir.path(), "evil.txt")));
+    }
+
+    void test_extractZip_duplicates()
+    {
+        QTemporaryDir dir;
+        auto archive = FS::PathCombine(dir.path(), "pack.zip");
+        QVERIFY(writeZip(archive, { { "pack/options.txt", "first" }, { "pack/other.txt", "other" }, { "pack/options.txt", "second" } }));
+
+        auto target = FS::PathCombine(dir.path(), "instance");
+        auto task = makeShared<MMCZip::ExtractZipTask>(archive, QDir(target), "pack/");
+        task->setMaxThreads(4);
+        QSignalSpy finished(task.get(), &Task::finished);
+        task->start();
+        QVERIFY(finished.wait(60000));
+        QVERIFY(task->wasSuccessful());
+
+        // the later entry wins, and only it counts towards the progress
+        QCOMPARE(FS::read(FS::PathCombine(target, "options.txt")), QByteArray("second"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "other.txt")), QByteArray("other"));
+        QCOMPARE(task->getTotalProgress(), qint64(11));
+#if !defined(Q_OS_WIN)
+        QVERIFY(QFileInfo(FS::PathCombine(target, "options.txt")).permission(QFileDevice::ExeUser));
+#endif
+    }
+
+    void test_exportToZip_data()
+    {
+        QTest::addColumn<int>("level");
+
+        QTest::newRow("default") << int(Z_DEFAULT_COMPRESSION);
+        QTest::newRow("fastest") << 1;
+        QTest::newRow("stored") << 0;
+    }
+
+    void test_exportToZip()
+    {
+        QFETCH(int, level);
+
+        QTemporaryDir dir;
+        auto root = FS::PathCombine(dir.path(), "instance");
+        QMap<QString, QByteArray> files;
+        files["mods/mod.jar"] = QByteArray(50000, 'j');
+        files["mods/old.jar.disabled"] = QByteArray(20000, 'd');
+        files["config/mod.toml"] = QByteArray("enabled = true\n").repeated(1000);
+        files["options.txt"] = "";
+        files["excluded.txt"] = "not exported";
+        // too big to be compressed in memory
+        files["saves/world/backup.dat"] = QByteArray(33 * 1024 * 1024, 'w');
+        for (int i = 0; i < 200; i++)
+            files[QString("saves/world/region/r.%1.0.mca").arg(i)] = QByteArray(1000 + i, static_cast<char>(i));
+        for (auto it = files.cbegin(); it != files.cend(); it++)
+            FS::write(FS::PathCombine(root, it.key()), it.value());
+
+        QFileInfoList list;
+        QVERIFY(MMCZip::collectFileListRecursively(root, nullptr, &list, nullptr));
+
+        auto out = FS::PathCombine(dir.path(), "export.zip");
+        auto task = makeShared<MMCZip::ExportToZipTask>(out, root, list, "overrides/");
+        task->setExcludeFiles({ "excluded.txt" });
+        task->addExtraFile("index.json", "{}");
+        task->setCompressionLevel(level);
+
+        QSignalSpy finished(task.get(), &Task::finished);
+        task->start();
+        QVERIFY(finished.wait(60000));
+        QVERIFY(task->wasSuccessful());
+
+        auto contents = readZip(out);
+        QCOMPARE(contents.size(), files.size());
+        QCOMPARE(contents["index.json"], QByteArray("{}"));
+        QVERIFY(!contents.contains("overrides/excluded.txt"));
+        for (auto it = files.cbegin(); it != files.cend(); it++) {
+            if (it.key() != "excluded.txt")
+                QCOMPARE(contents["overrides/" + it.key()], it.value());
+        }
+
+        // what's compressed already is stored as it is
+        QuaZip zip(out);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QuaZipFileInfo64 info;
+        for (auto name : { "overrides/mods/mod.jar", "overrides/mods/old.jar.disabled" }) {
+            QVERIFY(zip.setCurrentFile(name));
+            QVERIFY(zip.getCurrentFileInfo(&info));
+            QCOMPARE(int(info.method), 0);
+        }
+        for (auto name : { "overrides/config/mod.toml", "overrides/saves/world/backup.dat" }) {
+            QVERIFY(zip.setCurrentFile(name));
+            QVERIFY(zip.getCurrentFileInfo(&info));
+            QCOMPARE(int(info.method), level == 0 ? 0 : Z_DEFLATED);
+        }
+    }
+
+    void test_Benchmark_data()
+    {
+        QTest::addColumn<bool>("raw");
+
+        QTest::newRow("raw copy") << true;
+        QTest::newRow("recompress") << false;
+    }
+
+    void test_Benchmark()
+    {
+        QFETCH(bool, raw);
+
+        QTemporaryDir dir;
+        auto jar = FS::PathCombine(dir.path(), "vanilla.jar");
+        auto entries = syntheticJar(5000);
+        QVERIFY(writeZip(jar, entries));
+
+        auto out = FS::PathCombine(dir.path(), "minecraft.jar");
+        QBENCHMARK
+        {
+            QuaZip zipOut(out);
+            QVERIFY(zipOut.open(QuaZip::mdCreate));
+            QSet<QString> contained;
+            QVERIFY(raw ? MMCZip::mergeZipFiles(&zipOut, QFileInfo(jar), contained) : recompressZipFiles(&zipOut, jar));
+            zipOut.close();
+        }
+
+        auto contents = readZip(out);
+        QCOMPARE(contents.size(), entries.size());
+        QCOMPARE(contents[entries.first().first], entries.first().second);
+    }
+};
+
+QTEST_GUILESS_MAIN(MMCZipTest)
+
+#include "MMCZip_test.moc"
@@ -0,0 +1,89 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <minecraft/mod/ModDetailsCache.h>
+
+class ModDetailsCacheTest : public QObject {
+    Q_OBJECT
+
+    static ModDetails someDetails()
+    {
+        ModDetails details;
+        details.mod_id = "examplemod";
+        details.name = "Example Mod";
+        details.version = "1.2.3";
+        details.authors = QStringList{ "Alice", "Bob" };
+        details.licenses.append(ModLicense("MIT", "MIT", "https://opensource.org/licenses/MIT", "MIT License"));
+        details.icon_file = "assets/examplemod/icon.png";
+        return details;
+    }
+
+   private slots:
+    void test_roundTrip()
+    {
+        QTemporaryDir tempDir;
+        auto jar = FS::PathCombine(tempDir.path(), "examplemod.jar");
+        FS::write(jar, "not really a jar");
+        auto cacheFile = FS::PathCombine(tempDir.path(), "cache", "mods.json");
+
+        {
+            ModDetailsCache cache(cacheFile);
+            QVERIFY(!cache.find(QFileInfo(jar)).has_value());
+            cache.insert(QFileInfo(jar), someDetails());
+        }
+
+        ModDetailsCache cache(cacheFile);
+        auto details = cache.find(QFileInfo(jar));
+        QVERIFY(details.has_value());
+        QCOMPARE(details->mod_id, QString("examplemod"));
+        QCOMPARE(details->name, QString("Example Mod"));
+        QCOMPARE(details->version, QString("1.2.3"));
+        QCOMPARE(details->authors, QStringList({ "Alice", "Bob" }));
+        QCOMPARE(details->licenses.size(), 1);
+        QCOMPARE(details->licenses.first().url, QString("https://opensource.org/licenses/MIT"));
+        QCOMPARE(details->icon_file, QString("assets/examplemod/icon.png"));
+    }
+
+    void test_invalidation()
+    {
+        QTemporaryDir tempDir;
+        auto jar = FS::PathCombine(tempDir.path(), "examplemod.jar");
+        FS::write(jar, "not really a jar");
+
+        ModDetailsCache cache(FS::PathCombine(tempDir.path(), "mods.json"));
+        cache.insert(QFileInfo(jar), someDetails());
+        QVERIFY(cache.find(QFileInfo(jar)).has_value());
+
+        // a different size means different contents
+        FS::write(jar, "still not really a jar");
+        QVERIFY(!cache.find(QFileInfo(jar)).has_value());
+
+        cache.insert(QFileInfo(jar), someDetails());
+        cache.retain({});
+        QVERIFY(!cache.find(QFileInfo(jar)).has_value());
+    }
+
+    void test_folderGone()
+    {
+        QTemporaryDir tempDir;
+        auto mods = FS::PathCombine(tempDir.path(), "mods");
+        auto jar = FS::PathCombine(mods, "examplemod.jar");
+        FS::write(jar, "not really a jar");
+        auto cacheFile = FS::PathCombine(mods, ".index", ".cache", "mod_details.json");
+
+        {
+            ModDetailsCache cache(cacheFile, mods);
+            cache.insert(QFileInfo(jar), someDetails());
+            QVERIFY(FS::deletePath(mods));
+        }
+
+        // the deleted folder isn't brought back by saving the cache
+        QVERIFY(!QFileInfo::exists(mods));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsCacheTest)
+
+#include "ModDetailsCache_test.moc"
@@ -0,0 +1,124 @@
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <MurmurHash2.h>
+
+#include <StringUtils.h>
+
+// The original whitespace filter of the CurseForge fingerprint
+static bool isCurseForgeWhitespace(char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+static uint32_t legacyFingerprint(const QString& path)
+{
+    std::ifstream file_stream(StringUtils::toStdString(path).c_str(), std::ifstream::binary);
+    return MurmurHash2(std::move(file_stream), 4 * MiB, isCurseForgeWhitespace);
+}
+
+static const std::pair<const char*, MurmurHash2Kernel> kernels[] = {
+    { "scalar", MurmurHash2Kernel::Scalar },
+    { "sse2", MurmurHash2Kernel::SSE2 },
+    { "avx2", MurmurHash2Kernel::AVX2 },
+};
+
+class MurmurHash2Test : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_testdata_data()
+    {
+        QTest::addColumn<QString>("path");
+
+        QDirIterator it(QFINDTESTDATA("testdata"), { "*.jar", "*.zip" }, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            auto path = it.next();
+            QTest::newRow(path.toUtf8()) << path;
+        }
+    }
+    void test_testdata()
+    {
+        QFETCH(QString, path);
+
+        QFile file(path);
+        QVERIFY(file.open(QFile::ReadOnly));
+        auto data = file.readAll();
+
+        auto expected = legacyFingerprint(path);
+        for (auto [name, kernel] : kernels) {
+            if (!MurmurHash2KernelSupported(kernel))
+                continue;
+            QVERIFY2(CurseForgeMurmurHash2(data.constData(), data.size(), kernel) == expected, name);
+        }
+        QCOMPARE(CurseForgeMurmurHash2(data.constData(), data.size()), expected);
+    }
+
+    // every length around the SIMD block sizes, with more and more whitespace
+    void test_edges()
+    {
+        QRandomGenerator rng(42);
+        const char whitespace[] = { 9, 10, 13, 32 };
+
+        for (int density = 0; density <= 4; density++) {
+            for (int size = 0; size < 200; size++) {
+                QByteArray data(size, Qt::Uninitialized);
+                for (auto& c : data) {
+                    c = static_cast<char>(rng.bounded(256));
+                    if (density && rng.bounded(4) < density)
+                        c = whitespace[rng.bounded(4)];
+                }
+
+                auto expected = MurmurHash2(data.constData(), data.size(), isCurseForgeWhitespace);
+                for (auto [name, kernel] : kernels) {
+                    if (!MurmurHash2KernelSupported(kernel))
+                        continue;
+                    QVERIFY2(CurseForgeMurmurHash2(data.constData(), data.size(), kernel) == expected,
+                             qPrintable(QString("%1, size %2, density %3").arg(name).arg(size).arg(density)));
+                }
+            }
+        }
+    }
+
+    void benchmark_fingerprint_data()
+    {
+        QTest::addColumn<int>("kernel");
+        QTest::newRow("legacy") << -1;
+        for (auto [name, kernel] : kernels) {
+            if (MurmurHash2KernelSupported(kernel))
+                QTest::newRow(name) << static_cast<int>(kernel);
+        }
+    }
+    void benchmark_fingerprint()
+    {
+        QFETCH(int, kernel);
+
+        QByteArray data(16 * 1024 * 1024, Qt::Uninitialized);
+        QRandomGenerator rng(1);
+        for (auto& c : data)
+            c = static_cast<char>(rng.bounded(256));
+
+        auto run = [&data, kernel] {
+            if (kernel < 0)
+                return MurmurHash2(data.constData(), data.size(), isCurseForgeWhitespace);
+            return CurseForgeMurmurHash2(data.constData(), data.size(), static_cast<MurmurHash2Kernel>(kernel));
+        };
+
+        QElapsedTimer timer;
+        timer.start();
+        run();
+        qDebug() << QTest::currentDataTag() << ":" << qRound64(data.size() * 1e3 / qMax<qint64>(1, timer.nsecsElapsed())) << "MB/s";
+
+        QBENCHMARK
+        {
+            run();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MurmurHash2Test)
+
+#include "MurmurHash2_test.moc"
@@ -0,0 +1,211 @@
+#include <QNetworkProxy>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QTimer>
+
+#include <net/Download.h>
+#include <net/NetJob.h>
+
+#include <memory>
+
+/* Answers "GET /<size>/<anything>" with <size> bytes after a little while, and keeps track of how many requests it was
+ * answering at once, for each host name the client used. Only used for testing. */
+class LocalHttpServer : public QTcpServer {
+    Q_OBJECT
+
+   public:
+    explicit LocalHttpServer(int delay_ms = 0) : m_delay_ms(delay_ms)
+    {
+        connect(this, &QTcpServer::newConnection, this, &LocalHttpServer::acceptConnections);
+        listen(QHostAddress::Any);
+    }
+
+    QUrl url(const QString& host, qint64 size, int index) const
+    {
+        return QUrl(QString("http://%1:%2/%3/%4").arg(host).arg(serverPort()).arg(size).arg(index));
+    }
+
+    QStringList served;
+    QHash<QString, int> peakPerHost;
+    int peakTotal = 0;
+    int peakLarge = 0;
+
+   private:
+    void acceptConnections()
+    {
+        while (auto socket = nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket, buffer] {
+                buffer->append(socket->readAll());
+                int end;
+                while ((end = buffer->indexOf("\r\n\r\n")) != -1) {
+                    auto head = buffer->left(end);
+                    buffer->remove(0, end + 4);
+                    serve(socket, head);
+                }
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    void serve(QTcpSocket* socket, const QByteArray& head)
+    {
+        auto lines = head.split('\n');
+        auto path = QString::fromLatin1(lines.first().split(' ').value(1));
+        QString host;
+        for (auto& line : lines) {
+            if (line.toLower().startsWith("host:"))
+                host = QString::fromLatin1(line.mid(5).trimmed()).section(':', 0, 0);
+        }
+        const auto size = path.section('/', 1, 1).toLongLong();
+        const bool large = size >= NetJob::largeDownloadSize;
+
+        served.append(path);
+        auto& running = m_running[host];
+        running++;
+        peakPerHost[host] = qMax(peakPerHost.value(host), running);
+        m_running_total++;
+        peakTotal = qMax(peakTotal, m_running_total);
+        m_running_large += large;
+        peakLarge = qMax(peakLarge, m_running_large);
+
+        QTimer::singleShot(m_delay_ms, socket, [this, socket, host, size, large] {
+            m_running[host]--;
+            m_running_total--;
+            m_running_large -= large;
+
+            QByteArray response = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: ";
+            response += QByteArray::number(size) + "\r\n\r\n";
+            response += QByteArray(size, 'x');
+            socket->write(response);
+        });
+    }
+
+    int m_delay_ms;
+    QHash<QString, int> m_running;
+    int m_running_total = 0;
+    int m_running_large = 0;
+};
+
+class NetJobTest : public QObject {
+    Q_OBJECT
+
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+
+    static bool run(NetJob::Ptr job)
+    {
+        QSignalSpy finished(job.get(), &Task::finished);
+        job->start();
+        return finished.wait(120000) && job->wasSuccessful();
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        m_network.reset(new QNetworkAccessManager());
+        // the requests never leave this machine, even when there's a proxy configured for the tests
+        m_network->setProxy(QNetworkProxy::NoProxy);
+    }
+
+    void test_manySmallFiles()
+    {
+        LocalHttpServer server;
+        QVERIFY(server.isListening());
+
+        auto job = makeShared<NetJob>("ManySmallFiles", m_network);
+        job->setMaxConcurrent(8);
+        job->setMaxConcurrentPerHost(4);
+
+        const int count = 3000;
+        const qint64 size = 512;
+        std::vector<std::shared_ptr<QByteArray>> outputs;
+        for (int i = 0; i < count; i++) {
+            outputs.push_back(std::make_shared<QByteArray>());
+            job->addNetAction(Net::Download::makeByteArray(server.url("127.0.0.1", size, i), outputs.back()));
+        }
+
+        QVERIFY(run(job));
+        QCOMPARE(server.served.size(), count);
+        QVERIFY(server.peakPerHost.value("127.0.0.1") <= 4);
+        for (auto& output : outputs)
+            QCOMPARE(qint64(output->size()), size);
+
+        auto metrics = job->metrics();
+        QCOMPARE(metrics.requests, count);
+        QCOMPARE(metrics.failed, 0);
+        QCOMPARE(metrics.bytesReceived, count * size);
+        QVERIFY(metrics.peakPerHost <= 4);
+        QVERIFY(metrics.elapsedMs > 0);
+        QVERIFY(metrics.bytesPerSecond() > 0);
+    }
+
+    void test_limitsEachHost()
+    {
+        LocalHttpServer server(20);
+
+        auto job = makeShared<NetJob>("TwoHosts", m_network);
+        job->setMaxConcurrent(6);
+        job->setMaxConcurrentPerHost(2);
+
+        // the first host is queued entirely before the second one, which still has to be served alongside it
+        for (auto host : { "localhost", "127.0.0.1" }) {
+            for (int i = 0; i < 40; i++)
+                job->addNetAction(Net::Download::makeByteArray(server.url(host, 64, i), std::make_shared<QByteArray>()));
+        }
+
+        QVERIFY(run(job));
+        QCOMPARE(server.served.size(), 80);
+        QVERIFY(server.peakPerHost.value("localhost") <= 2);
+        QVERIFY(server.peakPerHost.value("127.0.0.1") <= 2);
+        QVERIFY(server.peakTotal > 2);
+        QCOMPARE(job->metrics().peakPerHost, 2);
+    }
+
+    void test_interleavesLargeDownloads()
+    {
+        LocalHttpServer server(20);
+
+        auto job = makeShared<NetJob>("SmallAndLarge", m_network);
+        job->setMaxConcurrent(4);
+
+        const qint64 large = NetJob::largeDownloadSize;
+        for (int i = 0; i < 20; i++)
+            job->addNetAction(Net::Download::makeByteArray(server.url("127.0.0.1", 64, i), std::make_shared<QByteArray>()));
+        for (int i = 0; i < 4; i++) {
+            auto dl = Net::Download::makeByteArray(server.url("127.0.0.1", large, i), std::make_shared<QByteArray>());
+            // what AssetObject and Library do with the sizes they know
+            dl->setProgress(0, large);
+            job->addNetAction(dl);
+        }
+
+        QVERIFY(run(job));
+        QCOMPARE(server.served.size(), 24);
+        // the large ones start right away, queued last or not, but never take more than half of the slots
+        QCOMPARE(server.served.mid(0, 4).filter(QString("/%1/").arg(large)).size(), 2);
+        QCOMPARE(server.peakLarge, 2);
+        QCOMPARE(job->metrics().bytesReceived, 20 * 64 + 4 * large);
+    }
+
+    void test_http2LiftsHostLimit()
+    {
+        LocalHttpServer server(20);
+
+        auto job = makeShared<NetJob>("Http2", m_network);
+        job->setMaxConcurrent(10);
+        job->setHttp2Allowed(true);
+
+        // the server only speaks HTTP/1.1, which has to keep working
+        for (int i = 0; i < 100; i++)
+            job->addNetAction(Net::Download::makeByteArray(server.url("127.0.0.1", 64, i), std::make_shared<QByteArray>()));
+
+        QVERIFY(run(job));
+        QCOMPARE(server.served.size(), 100);
+        QCOMPARE(job->metrics().peakPerHost, 10);
+    }
+};
+
+QTEST_GUILESS_MAIN(NetJobTest)
+
+#include "NetJob_test.moc"
@@ -0,0 +1,138 @@
+#include <QMutex>
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+
+#include <minecraft/mod/ResourceParseScheduler.h>
+
+class SleepTask : public Task {
+    Q_OBJECT
+   public:
+    SleepTask(int id, QList<int>& order, QMutex& lock, std::atomic<int>& running, std::atomic<int>& peak)
+        : Task(nullptr, false), m_id(id), m_order(order), m_lock(lock), m_running(running), m_peak(peak)
+    {}
+
+    bool abort() override
+    {
+        m_aborted = true;
+        return true;
+    }
+
+   protected:
+    void executeTask() override
+    {
+        auto now = ++m_running;
+        auto peak = m_peak.load();
+        while (now > peak && !m_peak.compare_exchange_weak(peak, now)) {}
+
+        {
+            QMutexLocker locker(&m_lock);
+            m_order.append(m_id);
+        }
+        QThread::msleep(10);
+
+        --m_running;
+        if (m_aborted)
+            emit finished();
+        else
+            emitSucceeded();
+    }
+
+   private:
+    int m_id;
+    QList<int>& m_order;
+    QMutex& m_lock;
+    std::atomic<int>& m_running;
+    std::atomic<int>& m_peak;
+    std::atomic<bool> m_aborted = false;
+};
+
+class ResourceParseSchedulerTest : public QObject {
+    Q_OBJECT
+
+    QList<int> m_order;
+    QMutex m_lock;
+    std::atomic<int> m_running = 0;
+    std::atomic<int> m_peak = 0;
+
+    Task::Ptr makeTask(int id) { return Task::Ptr(new SleepTask(id, m_order, m_lock, m_running, m_peak)); }
+
+    static void waitIdle(ResourceParseScheduler& scheduler)
+    {
+        QTRY_VERIFY_WITH_TIMEOUT(scheduler.isIdle(), 10000);
+    }
+
+   private slots:
+    void init()
+    {
+        m_order.clear();
+        m_running = 0;
+        m_peak = 0;
+    }
+
+    void test_concurrencyLimit()
+    {
+        ResourceParseScheduler scheduler;
+        scheduler.setMaxConcurrent(3);
+
+        for (int i = 0; i < 20; i++)
+            scheduler.schedule(i, makeTask(i));
+        QCOMPARE(scheduler.runningCount(), 3);
+        QCOMPARE(scheduler.pendingCount(), 17);
+
+        waitIdle(scheduler);
+        QCOMPARE(m_order.size(), 20);
+        QVERIFY(m_peak <= 3);
+    }
+
+    void test_prioritize()
+    {
+        ResourceParseScheduler scheduler;
+
+        for (int i = 0; i < 5; i++)
+            scheduler.schedule(i, makeTask(i));
+        // 0 is already running, 3 and 4 jump ahead of the others
+        scheduler.prioritize({ 4, 3 });
+
+        waitIdle(scheduler);
+        QCOMPARE(m_order, QList<int>({ 0, 3, 4, 1, 2 }));
+    }
+
+    void test_cancel()
+    {
+        ResourceParseScheduler scheduler;
+
+        QList<qint64> progress;
+        connect(&scheduler, &ResourceParseScheduler::progress, this, [&progress](qint64 current, qint64) { progress.append(current); });
+
+        for (int i = 0; i < 4; i++)
+            scheduler.schedule(i, makeTask(i));
+
+        QVERIFY(scheduler.cancel(2));
+        QVERIFY(!scheduler.cancel(42));
+        QCOMPARE(scheduler.pendingCount(), 2);
+
+        waitIdle(scheduler);
+        QCOMPARE(m_order, QList<int>({ 0, 1, 3 }));
+        QCOMPARE(progress.last(), 4);
+    }
+
+    void test_cancelAll()
+    {
+        ResourceParseScheduler scheduler;
+        scheduler.setMaxConcurrent(2);
+
+        for (int i = 0; i < 10; i++)
+            scheduler.schedule(i, makeTask(i));
+        scheduler.cancelAll();
+        QCOMPARE(scheduler.pendingCount(), 0);
+
+        scheduler.waitForDone();
+        QVERIFY(m_order.size() <= 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(ResourceParseSchedulerTest)
+
+#include "ResourceParseScheduler_test.moc"
@@ -6,6 +6,7 @@
 #include <tasks/MultipleOptionsTask.h>
 #include <tasks/SequentialTask.h>
 #include <tasks/Task.h>
+#include <tasks/ThenTask.h>
 
 #include <array>
 
@@ -22,6 +23,14 @@ class BasicTask : public Task {
     void executeTask() override { emitSucceeded(); }
 };
 
+/* Fails right away. Only used for testing. */
+class FailingTask : public Task {
+    Q_OBJECT
+
+   private:
+    void executeTask() override { emitFailed("expected failure"); }
+};
+
 /* Does nothing. Only used for testing. */
 class BasicTask_MultiStep : public Task {
     Q_OBJECT
@@ -245,6 +254,107 @@ class TaskTest : public QObject {
         QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
     }
 
+    void test_thenRun()
+    {
+        auto t1 = makeShared<BasicTask>();
+        Task::Ptr t2 = makeShared<BasicTask>();
+
+        bool continued = false;
+        auto t = Tasks::then(t1, [&] {
+            continued = t1->wasSuccessful();
+            return t2;
+        });
+
+        t->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t->wasSuccessful());
+        QVERIFY(continued);
+        QVERIFY(t2->wasSuccessful());
+    }
+
+    void test_thenStopsOnFailure()
+    {
+        auto t1 = makeShared<FailingTask>();
+
+        bool continued = false;
+        auto t = Tasks::then(t1, [&] { continued = true; });
+
+        t->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!t->wasSuccessful());
+        QCOMPARE(t->failReason(), QString("expected failure"));
+        QVERIFY(!continued);
+    }
+
+    void test_thenUsesFinishedTask()
+    {
+        auto t1 = makeShared<BasicTask>();
+        t1->start();
+        QVERIFY(t1->wasSuccessful());
+
+        int runs = 0;
+        connect(t1.get(), &Task::started, [&] { runs++; });
+
+        bool continued = false;
+        auto t = Tasks::then(t1, [&] { continued = true; });
+
+        t->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t->wasSuccessful());
+        QVERIFY(continued);
+        QCOMPARE(runs, 0);
+    }
+
+    void test_afterFinishedCarriesOnAfterFailure()
+    {
+        // like a metadata refresh that fails, after the local copy was loaded already
+        bool loaded = false;
+        auto refresh = makeShared<FailingTask>();
+        connect(refresh.get(), &Task::started, [&] { loaded = true; });
+        Task::Ptr t2 = makeShared<BasicTask>();
+
+        bool continued = false;
+        auto t = Tasks::afterFinished(refresh, [&]() -> Task::Ptr {
+            continued = loaded;
+            return t2;
+        });
+
+        t->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(continued);
+        QVERIFY(t->wasSuccessful());
+        QVERIFY(t2->wasSuccessful());
+
+        // a failure of the step after that still fails the whole chain
+        auto failing = Tasks::afterFinished(makeShared<FailingTask>(), [] { return Task::Ptr(makeShared<FailingTask>()); });
+        failing->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return failing->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!failing->wasSuccessful());
+    }
+
+    void test_whenAll()
+    {
+        QList<Task::Ptr> tasks;
+        for (int i = 0; i < 9; i++)
+            tasks.append(makeShared<BasicTask>());
+        tasks.append(nullptr);
+
+        auto t = Tasks::whenAll(tasks, 3);
+
+        t->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t->wasSuccessful());
+        for (auto& task : tasks) {
+            if (task)
+                QVERIFY(task->wasSuccessful());
+        }
+
+        auto failing = Tasks::whenAll({ makeShared<BasicTask>(), makeShared<FailingTask>() });
+        failing->start();
+        QVERIFY2(QTest::qWaitFor([&]() { return failing->isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!failing->wasSuccessful());
+    }
+
     void test_stackOverflowInConcurrentTask()
     {
         QEventLoop loop;